@@ -0,0 +1,351 @@
+#include "tiny3d.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+/* Microbenchmarks
+ * Every benchmark runs a few warmup repetitions, then times each
+ * repetition separately with a monotonic clock. Results go to stdout as a
+ * table and to a JSON file that can be diffed across commits:
+ *
+ *   build/bench [--output PATH] [--label TEXT] [--quick]
+ *
+ * --quick cuts the repetitions and skips the largest mesh, for smoke runs. */
+
+#define BENCH_CANVAS 1024
+#define BENCH_BATCH 65536   // Items per repetition for the per-call kernels
+
+typedef struct {
+    const char* name;
+    const char* unit;       // Throughput unit, e.g. "pixels/s"
+    int warmup;
+    int reps;
+    double items;           // Items processed per repetition
+    double median_ns;
+    double p99_ns;
+} bench_result_t;
+
+static double now_ns(void) {
+    struct timespec ts;
+#ifdef _WIN32
+    timespec_get(&ts, TIME_UTC);
+#else
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+#endif
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static int compare_doubles(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+static int quick = 0;
+static bench_result_t results[64];
+static int result_count = 0;
+
+/* Time fn(ctx) and record the result */
+static void run_bench(const char* name, const char* unit, double items, int warmup, int reps,
+                      void (*fn)(void*), void* ctx) {
+    if (quick) {
+        warmup = warmup > 1 ? 1 : warmup;
+        reps = reps > 5 ? 5 : reps;
+    }
+    for (int i = 0; i < warmup; i++) fn(ctx);
+
+    double* samples = (double*)malloc(sizeof(double) * (size_t)reps);
+    for (int i = 0; i < reps; i++) {
+        double start = now_ns();
+        fn(ctx);
+        samples[i] = now_ns() - start;
+    }
+    qsort(samples, (size_t)reps, sizeof(double), compare_doubles);
+
+    bench_result_t* r = &results[result_count++];
+    r->name = name;
+    r->unit = unit;
+    r->warmup = warmup;
+    r->reps = reps;
+    r->items = items;
+    r->median_ns = reps % 2 ? samples[reps / 2] : 0.5 * (samples[reps / 2 - 1] + samples[reps / 2]);
+    int p99 = (int)ceil(0.99 * reps) - 1;
+    r->p99_ns = samples[p99 < 0 ? 0 : p99];
+    free(samples);
+
+    printf("%-34s %12.1f us median %12.1f us p99 %14.4g %s\n",
+           name, r->median_ns / 1e3, r->p99_ns / 1e3, items / (r->median_ns * 1e-9), unit);
+}
+
+/* Keeps results observable so the compiler cannot drop the work */
+static volatile float sink;
+
+/* Lines: many angles of one length and thickness */
+typedef struct {
+    canvas_t* canvas;
+    float length;
+    float thickness;
+} line_ctx_t;
+
+#define LINES_PER_REP 256
+
+static void bench_lines(void* p) {
+    line_ctx_t* c = (line_ctx_t*)p;
+    float cx = BENCH_CANVAS * 0.5f, cy = BENCH_CANVAS * 0.5f;
+    for (int i = 0; i < LINES_PER_REP; i++) {
+        float a = (float)i * 0.0245f;
+        float dx = cosf(a) * c->length * 0.5f, dy = sinf(a) * c->length * 0.5f;
+        draw_line_f(c->canvas, cx - dx, cy - dy, cx + dx, cy + dy, c->thickness);
+    }
+}
+
+/* Pixels one pass of bench_lines touches, counted line by line */
+static double line_pixels(canvas_t* canvas, float length, float thickness) {
+    double total = 0.0;
+    for (int i = 0; i < LINES_PER_REP; i += 32) {
+        clear_canvas(canvas, 0.0f);
+        float a = (float)i * 0.0245f;
+        float dx = cosf(a) * length * 0.5f, dy = sinf(a) * length * 0.5f;
+        float cx = BENCH_CANVAS * 0.5f, cy = BENCH_CANVAS * 0.5f;
+        draw_line_f(canvas, cx - dx, cy - dy, cx + dx, cy + dy, thickness);
+        for (int y = 0; y < canvas->height; y++) {
+            const float* row = canvas_row(canvas, y);
+            for (int x = 0; x < canvas->width; x++) total += row[x] > 0.0f;
+        }
+    }
+    return total * 32.0;
+}
+
+static void bench_set_pixel(void* p) {
+    canvas_t* canvas = (canvas_t*)p;
+    for (int i = 0; i < BENCH_BATCH; i++) {
+        set_pixel_f(canvas, (float)(i % 997) + 0.25f, (float)(i % 991) + 0.5f, 0.1f);
+    }
+}
+
+static void bench_clear(void* p) {
+    clear_canvas((canvas_t*)p, 0.0f);
+}
+
+static void bench_mat4_mul(void* p) {
+    (void)p;
+    mat4_t acc = mat4_identity();
+    mat4_t step = mat4_rotate_xyz(0.001f, 0.002f, 0.003f);
+    for (int i = 0; i < BENCH_BATCH; i++) acc = mat4_mul(acc, step);
+    sink = acc.m[0][0];
+}
+
+typedef struct {
+    vec3_t* points;
+    float *x, *y, *z, *out_x, *out_y, *out_depth;
+    vec3_t* normals;
+    light_t lights[MAX_LIGHTS];
+    int light_count;
+    light_set_t set;
+    float* shade;
+    mat4_t mvp;
+} vertex_ctx_t;
+
+static void bench_mat4_mul_vec3(void* p) {
+    vertex_ctx_t* c = (vertex_ctx_t*)p;
+    float acc = 0.0f;
+    for (int i = 0; i < BENCH_BATCH; i++) acc += mat4_mul_vec3(c->mvp, c->points[i]).x;
+    sink = acc;
+}
+
+static void bench_transform_soa(void* p) {
+    vertex_ctx_t* c = (vertex_ctx_t*)p;
+    transform_points_soa(&c->mvp, c->x, c->y, c->z, BENCH_BATCH, 512.0f, 512.0f,
+                         c->out_x, c->out_y, c->out_depth, NULL);
+}
+
+static void bench_compute_lighting(void* p) {
+    vertex_ctx_t* c = (vertex_ctx_t*)p;
+    float acc = 0.0f;
+    for (int i = 0; i < BENCH_BATCH; i++) acc += compute_lighting(c->normals[i], c->lights, c->light_count);
+    sink = acc;
+}
+
+static void bench_light_set(void* p) {
+    vertex_ctx_t* c = (vertex_ctx_t*)p;
+    light_set_shade_soa(&c->set, c->x, c->y, c->z, BENCH_BATCH, c->shade);
+}
+
+static void bench_sincos(void* p) {
+    vertex_ctx_t* c = (vertex_ctx_t*)p;
+    trig_sincos_n(c->x, c->out_x, c->out_y, BENCH_BATCH, TRIG_ACCURATE);
+}
+
+/* UV sphere with about edge_target edges: meridians and parallels */
+typedef struct {
+    vec3_t* vertices;
+    int* edges;
+    int vertex_count;
+    int edge_count;
+    canvas_t* canvas;
+    arena_t arena;
+    render_options_t options;
+    mat4_t mvp;
+} mesh_ctx_t;
+
+static void make_sphere(mesh_ctx_t* m, int edge_target) {
+    int segs = (int)sqrtf((float)edge_target);
+    int rings = segs / 2;
+    m->vertex_count = segs * (rings - 1) + 2;
+    m->vertices = (vec3_t*)malloc(sizeof(vec3_t) * (size_t)m->vertex_count);
+    m->edges = (int*)malloc(sizeof(int) * 2 * (size_t)segs * (2 * rings - 1));
+    m->edge_count = 0;
+
+    int north = m->vertex_count - 2, south = m->vertex_count - 1;
+    m->vertices[north] = (vec3_t){0.0f, 0.0f, 1.0f};
+    m->vertices[south] = (vec3_t){0.0f, 0.0f, -1.0f};
+    for (int r = 1; r < rings; r++) {
+        for (int s = 0; s < segs; s++) {
+            int v = (r - 1) * segs + s;
+            m->vertices[v] = vec3_from_spherical(1.0f, (float)M_PI * r / rings, 2.0f * (float)M_PI * s / segs);
+            // Parallel to the next segment, meridian to the ring above
+            m->edges[2 * m->edge_count] = v;
+            m->edges[2 * m->edge_count++ + 1] = (r - 1) * segs + (s + 1) % segs;
+            m->edges[2 * m->edge_count] = v;
+            m->edges[2 * m->edge_count++ + 1] = r == 1 ? north : v - segs;
+        }
+    }
+    for (int s = 0; s < segs; s++) {
+        m->edges[2 * m->edge_count] = (rings - 2) * segs + s;
+        m->edges[2 * m->edge_count++ + 1] = south;
+    }
+}
+
+static void bench_render(void* p) {
+    mesh_ctx_t* m = (mesh_ctx_t*)p;
+    arena_reset(&m->arena);
+    render_wireframe_ex(m->canvas, m->mvp, m->vertices, m->vertex_count, m->edges, m->edge_count,
+                        1.0f, &m->options);
+}
+
+/* Quoted JSON string; quotes, backslashes and control characters are escaped */
+static void write_json_string(FILE* f, const char* s) {
+    fputc('"', f);
+    for (; *s; s++) {
+        unsigned char ch = (unsigned char)*s;
+        if (ch == '"' || ch == '\\') fprintf(f, "\\%c", ch);
+        else if (ch < 0x20) fprintf(f, "\\u%04x", ch);
+        else fputc(ch, f);
+    }
+    fputc('"', f);
+}
+
+static void write_json(FILE* f, const char* label) {
+    fprintf(f, "{\n  \"label\": ");
+    write_json_string(f, label);
+    fprintf(f, ",\n  \"isa\": \"%s\",\n  \"benchmarks\": [\n", simd_isa_name(simd_active_isa()));
+    for (int i = 0; i < result_count; i++) {
+        const bench_result_t* r = &results[i];
+        fprintf(f, "    {\"name\": \"%s\", \"warmup\": %d, \"repetitions\": %d, \"items\": %.0f, "
+                   "\"median_ns\": %.0f, \"p99_ns\": %.0f, \"throughput\": %.6g, \"unit\": \"%s\"}%s\n",
+                r->name, r->warmup, r->reps, r->items, r->median_ns, r->p99_ns,
+                r->items / (r->median_ns * 1e-9), r->unit, i + 1 < result_count ? "," : "");
+    }
+    fprintf(f, "  ]\n}\n");
+}
+
+int main(int argc, char** argv) {
+    const char* output = "build/bench.json";
+    const char* label = "";
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) output = argv[++i];
+        else if (strcmp(argv[i], "--label") == 0 && i + 1 < argc) label = argv[++i];
+        else if (strcmp(argv[i], "--quick") == 0) quick = 1;
+    }
+
+    canvas_t* canvas = create_canvas(BENCH_CANVAS, BENCH_CANVAS);
+
+    // Canvas kernels
+    static char names[9][48];
+    float lengths[3] = {16.0f, 128.0f, 512.0f};
+    float thicknesses[3] = {1.0f, 3.0f, 8.0f};
+    for (int t = 0; t < 3; t++) {
+        for (int l = 0; l < 3; l++) {
+            line_ctx_t ctx = {canvas, lengths[l], thicknesses[t]};
+            char* name = names[t * 3 + l];
+            snprintf(name, sizeof(names[0]), "draw_line_f/len%d/thick%d", (int)lengths[l], (int)thicknesses[t]);
+            double pixels = line_pixels(canvas, lengths[l], thicknesses[t]);
+            run_bench(name, "pixels/s", pixels, 3, 50, bench_lines, &ctx);
+        }
+    }
+    run_bench("set_pixel_f", "calls/s", BENCH_BATCH, 3, 50, bench_set_pixel, canvas);
+    run_bench("clear_canvas/1024x1024", "pixels/s", (double)BENCH_CANVAS * BENCH_CANVAS, 5, 100,
+              bench_clear, canvas);
+
+    // Math and lighting
+    vertex_ctx_t v;
+    v.points = (vec3_t*)malloc(sizeof(vec3_t) * BENCH_BATCH);
+    v.normals = (vec3_t*)malloc(sizeof(vec3_t) * BENCH_BATCH);
+    float* block = (float*)malloc(sizeof(float) * BENCH_BATCH * 7);
+    v.x = block;
+    v.y = block + BENCH_BATCH;
+    v.z = block + 2 * BENCH_BATCH;
+    v.out_x = block + 3 * BENCH_BATCH;
+    v.out_y = block + 4 * BENCH_BATCH;
+    v.out_depth = block + 5 * BENCH_BATCH;
+    v.shade = block + 6 * BENCH_BATCH;
+    for (int i = 0; i < BENCH_BATCH; i++) {
+        v.points[i] = (vec3_t){sinf(i * 0.1f), cosf(i * 0.3f), sinf(i * 0.7f) - 3.0f};
+        v.normals[i] = (vec3_t){cosf(i * 0.2f), sinf(i * 0.5f), cosf(i * 0.9f)};
+    }
+    vec3_to_soa(v.points, BENCH_BATCH, v.x, v.y, v.z);
+    v.mvp = mat4_mul(mat4_rotate_xyz(0.3f, 0.5f, 0.7f), mat4_frustum_asymmetric(-1, 1, -1, 1, 1, 100));
+    v.light_count = 0;
+    light_set_init(&v.set);
+    vec3_t dirs[3] = {{1, 1, 1}, {-1, 0.5f, 0}, {0, -1, 2}};
+    for (int i = 0; i < 3; i++) {
+        add_light(v.lights, &v.light_count, dirs[i], 0.4f);
+        light_set_add(&v.set, dirs[i], 0.4f);
+    }
+
+    run_bench("mat4_mul", "ops/s", BENCH_BATCH, 3, 50, bench_mat4_mul, NULL);
+    run_bench("mat4_mul_vec3", "vertices/s", BENCH_BATCH, 3, 50, bench_mat4_mul_vec3, &v);
+    run_bench("transform_points_soa", "vertices/s", BENCH_BATCH, 3, 50, bench_transform_soa, &v);
+    run_bench("compute_lighting/3_lights", "normals/s", BENCH_BATCH, 3, 50, bench_compute_lighting, &v);
+    run_bench("light_set_shade_soa/3_lights", "normals/s", BENCH_BATCH, 3, 50, bench_light_set, &v);
+    run_bench("trig_sincos_n", "values/s", BENCH_BATCH, 3, 50, bench_sincos, &v);
+
+    // End to end: spheres from 1k to 1M edges on a 512x512 canvas
+    canvas_t* view = create_canvas(512, 512);
+    int targets[4] = {1000, 10000, 100000, 1000000};
+    const char* mesh_names[4] = {"render_wireframe/sphere_1k", "render_wireframe/sphere_10k",
+                                 "render_wireframe/sphere_100k", "render_wireframe/sphere_1m"};
+    int mesh_reps[4] = {200, 50, 20, 5};
+    for (int i = 0; i < (quick ? 3 : 4); i++) {
+        mesh_ctx_t m;
+        make_sphere(&m, targets[i]);
+        m.canvas = view;
+        arena_init(&m.arena, NULL, 0);
+        memset(&m.options, 0, sizeof(m.options));
+        m.options.arena = &m.arena;
+        // mat4_mul(a, b) applies a first: object to world, then world to clip
+        mat4_t world = mat4_mul(mat4_rotate_xyz(0.4f, 0.2f, 0.0f), mat4_translate(0.0f, 0.0f, -3.0f));
+        m.mvp = mat4_mul(world, mat4_frustum_asymmetric(-1, 1, -1, 1, 1, 100));
+        run_bench(mesh_names[i], "edges/s", m.edge_count, 2, mesh_reps[i], bench_render, &m);
+        arena_free(&m.arena);
+        free(m.vertices);
+        free(m.edges);
+    }
+
+    FILE* f = fopen(output, "w");
+    if (!f) {
+        fprintf(stderr, "Cannot write %s\n", output);
+        return 1;
+    }
+    write_json(f, label);
+    fclose(f);
+    printf("Results written to %s\n", output);
+
+    free(block);
+    free(v.points);
+    free(v.normals);
+    free_canvas(view);
+    free_canvas(canvas);
+    return 0;
+}
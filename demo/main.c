@@ -3,10 +3,13 @@
 #include <time.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
 
 #ifdef _WIN32
 #include <windows.h>
 #include <conio.h>
+#include <io.h>
 #else
 #include <unistd.h>
 #include <termios.h>
@@ -17,6 +20,8 @@
 #define HEIGHT 400
 #define FPS 10
 #define FRAME_DELAY (1000000/FPS)
+#define HEADLESS_FPS 30
+#define HEADLESS_FRAMES 300
 
 /* Keyboard input setup */
 #ifdef _WIN32
@@ -66,19 +71,159 @@ void generate_soccer_ball(vec3_t** vertices, int** edges, int* vcount, int* ecou
     }
 }
 
-int main() {
-    enable_raw_mode();
-    canvas_t* canvas = create_canvas(WIDTH, HEIGHT);
-    
+/* Meshes and camera shared by the interactive and headless loops */
+typedef struct {
     vec3_t *ball_verts, *cube_verts;
     int *ball_edges, *cube_edges;
     int ball_vcount, ball_ecount, cube_vcount, cube_ecount;
+    mat4_t view, proj;
+    light_set_t lights;   // Lights for the lit scene
+} demo_models_t;
+
+/* Draw one frame of a canvas-based phase (every phase but the ASCII cube) */
+void render_demo_phase(canvas_t* canvas, int demo_phase, float angle,
+                       const demo_models_t* m, const render_options_t* render_opts) {
+    // mat4_mul(a, b) applies a first: object to world, then world to clip
+    mat4_t view_proj = mat4_mul(m->view, m->proj);
+
+    if (demo_phase == 0) {
+        float center_x = WIDTH / 2.0f;
+        float center_y = HEIGHT / 2.0f;
+        float radius = (WIDTH < HEIGHT ? WIDTH : HEIGHT) * 0.4f;
+
+        for (int i = 0; i < 24; i++) {
+            float line_angle = i * 15.0f * M_PI / 180.0f;
+            float end_x = center_x + cosf(line_angle) * radius;
+            float end_y = center_y + sinf(line_angle) * radius;
+            draw_line_f(canvas, center_x, center_y, end_x, end_y, 3.0f);
+        }
+
+        for (float a = 0; a < 2 * M_PI; a += 0.1f) {
+            float x = center_x + cosf(a) * 4.0f;
+            float y = center_y + sinf(a) * 4.0f;
+            set_pixel_f(canvas, x, y, 1.0f);
+        }
+    } 
+    
+    else if (demo_phase == 2) {
+        mat4_t ball_model = mat4_rotate_xyz(angle * 0.7f, angle, angle * 0.3f);
+        mat4_t ball_mvp = mat4_mul(ball_model, view_proj);
+        
+        render_wireframe_ex(canvas, ball_mvp, m->ball_verts, m->ball_vcount, 
+                            m->ball_edges, m->ball_ecount, 1.5f, render_opts);
+    } 
     
-    generate_soccer_ball(&ball_verts, &ball_edges, &ball_vcount, &ball_ecount);
-    create_cube(&cube_verts, &cube_edges, &cube_vcount, &cube_ecount);
+    else if (demo_phase == 3) {
+        // Per-vertex lighting on the ball, per-edge lighting on the cube
+        render_options_t lit = *render_opts;
+        lit.lights = &m->lights;
 
-    mat4_t view = mat4_translate(0, 0, -8);
-    mat4_t proj = mat4_frustum_asymmetric(-1, 1, -1, 1, 1, 100);
+        mat4_t ball_model = mat4_rotate_xyz(angle * 0.7f, angle, angle * 0.3f);
+        mat4_t ball_mvp = mat4_mul(ball_model, view_proj);
+        lit.lighting = RENDER_LIGHT_VERTEX;
+        lit.model = &ball_model;
+        render_wireframe_ex(canvas, ball_mvp, m->ball_verts, m->ball_vcount, 
+                            m->ball_edges, m->ball_ecount, 1.5f, &lit);
+
+        mat4_t cube2_model = mat4_translate(-2.0f, 0.0f, -4);
+        cube2_model = mat4_mul(cube2_model, mat4_rotate_xyz(angle * 1.2f, angle * 0.8f, angle * 0.4f));
+        mat4_t cube2_mvp = mat4_mul(cube2_model, view_proj);
+        lit.lighting = RENDER_LIGHT_EDGE;
+        lit.model = &cube2_model;
+        render_wireframe_ex(canvas, cube2_mvp, m->cube_verts, m->cube_vcount,
+                            m->cube_edges, m->cube_ecount, 1.2f, &lit);
+    }
+}
+
+/* Render the animation as fast as possible and stream it as Y4M */
+int run_headless(const demo_models_t* models, int frames, const char* output) {
+    int fd = 1;
+    if (output) {
+        // A named pipe blocks here until the encoder opens it
+        fd = open(output, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) {
+            fprintf(stderr, "Cannot open %s\n", output);
+            return 1;
+        }
+    }
+
+    canvas_t* canvas = create_canvas(WIDTH, HEIGHT);
+    arena_t frame_arena;
+    arena_init(&frame_arena, NULL, 0);
+    render_options_t render_opts = {0};
+    render_opts.arena = &frame_arena;
+    video_writer_t* video = video_open_y4m(fd, WIDTH, HEIGHT, HEADLESS_FPS);
+
+    int status = video ? 0 : 1;
+    float angle = 0;
+    for (int frame = 0; frame < frames && status == 0; frame++) {
+        clear_canvas(canvas, 0.0f);
+        arena_reset(&frame_arena);
+        render_demo_phase(canvas, 3, angle, models, &render_opts);
+        // Frame N is written by the video thread while frame N+1 renders
+        if (video_submit_frame(video, canvas) != 0) status = 1;
+        angle += 0.01f;
+    }
+    if (video && video_close(video) != 0) status = 1;
+
+    arena_free(&frame_arena);
+    free_canvas(canvas);
+    if (output) close(fd);
+    if (status != 0) fprintf(stderr, "Writing the video stream failed\n");
+    return status;
+}
+
+int main(int argc, char** argv) {
+    // --headless [--frames N] [--output PATH] streams Y4M instead of drawing to the terminal
+    int headless = 0, frames = HEADLESS_FRAMES;
+    const char* output = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--headless") == 0) headless = 1;
+        else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) frames = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) output = argv[++i];
+    }
+
+    demo_models_t models;
+    generate_soccer_ball(&models.ball_verts, &models.ball_edges, &models.ball_vcount, &models.ball_ecount);
+    create_cube(&models.cube_verts, &models.cube_edges, &models.cube_vcount, &models.cube_ecount);
+    models.view = mat4_translate(0, 0, -8);
+    models.proj = mat4_frustum_asymmetric(-1, 1, -1, 1, 1, 100);
+    light_set_init(&models.lights);
+    light_set_add(&models.lights, (vec3_t){ -1, 1, 1 }, 0.8f);   // Key light, upper left front
+    light_set_add(&models.lights, (vec3_t){ 1, -0.5f, 0.5f }, 0.3f);  // Fill
+    light_set_add(&models.lights, (vec3_t){ 0, 0, -1 }, 0.15f);  // Rim, so back edges stay visible
+
+    vec3_t *cube_verts = models.cube_verts;
+    int *cube_edges = models.cube_edges;
+    int cube_vcount = models.cube_vcount, cube_ecount = models.cube_ecount;
+
+    if (headless) {
+        int status = run_headless(&models, frames, output);
+        free(models.ball_verts);
+        free(models.ball_edges);
+        free(cube_verts);
+        free(cube_edges);
+        return status;
+    }
+
+    enable_raw_mode();
+    canvas_t* canvas = create_canvas(WIDTH, HEIGHT);
+
+    // Renderer scratch for the whole frame, reset once per frame
+    arena_t frame_arena;
+    arena_init(&frame_arena, NULL, 0);
+    render_options_t render_opts = {0};
+    render_opts.arena = &frame_arena;
+
+    // Terminal output: row 1 is the title, the 40x40 cells start below it
+    presenter_t presenter;
+    presenter_config_t present_cfg = {0};
+    present_cfg.cols = 40;
+    present_cfg.rows = 40;
+    present_cfg.origin_row = 2;
+    presenter_init(&presenter, &present_cfg);
+    presenter_clear_screen(&presenter);
+    char status[128];
 
     float angle = 0;
     float time = 0;
@@ -87,28 +232,9 @@ int main() {
     
     while (1) {
         clear_canvas(canvas, 0.0f);
+        arena_reset(&frame_arena);
         
-        if (demo_phase == 0) {
-            int disp_size = 40;
-            float center_x = WIDTH / 2.0f;
-            float center_y = HEIGHT / 2.0f;
-            float radius = (WIDTH < HEIGHT ? WIDTH : HEIGHT) * 0.4f;
-
-            for (int i = 0; i < 24; i++) {
-                float line_angle = i * 15.0f * M_PI / 180.0f;
-                float end_x = center_x + cosf(line_angle) * radius;
-                float end_y = center_y + sinf(line_angle) * radius;
-                draw_line_f(canvas, center_x, center_y, end_x, end_y, 3.0f);
-            }
-
-            for (float a = 0; a < 2 * M_PI; a += 0.1f) {
-                float x = center_x + cosf(a) * 4.0f;
-                float y = center_y + sinf(a) * 4.0f;
-                set_pixel_f(canvas, x, y, 1.0f);
-            }
-        } 
-        
-        else if (demo_phase == 1) {
+        if (demo_phase == 1) {
             // Task 2: 3D Cube Transformation using math3d
             int disp_size = 40;
             char grid[40][41];
@@ -150,9 +276,11 @@ int main() {
                 }
             }
             // Print grid
-            for (int y = 0; y < disp_size; y++) printf("%s\n", grid[y]);
+            presenter_text(&presenter, 1, "=== Task 2: 3D Cube Transformation Demo ===");
+            for (int y = 0; y < disp_size; y++) presenter_text(&presenter, 2 + y, grid[y]);
             // Skip the normal canvas rendering for this phase
-            printf("\nPress Q to quit, SPACE to change task\n");
+            presenter_text(&presenter, 2 + disp_size + 1, "Press Q to quit, SPACE to change task");
+            presenter_flush(&presenter);
             if (kbhit()) {
 #ifdef _WIN32
                 char c = _getch();
@@ -160,7 +288,10 @@ int main() {
                 char c = getchar();
 #endif
                 if (c == 'q' || c == 'Q') break;
-                if (c == ' ') demo_phase = (demo_phase + 1) % NUM_PHASES;
+                if (c == ' ') {
+                    demo_phase = (demo_phase + 1) % NUM_PHASES;
+                    presenter_clear_screen(&presenter);
+                }
             }
             angle += 0.01f;
             time += 1.0f / FPS;
@@ -172,55 +303,21 @@ int main() {
             continue;
         } 
         
-        else if (demo_phase == 2) {
-            mat4_t ball_model = mat4_rotate_xyz(angle * 0.7f, angle, angle * 0.3f);
-            mat4_t ball_mvp = mat4_mul(mat4_mul(proj, view), ball_model);
-            
-            render_wireframe(canvas, ball_mvp, ball_verts, ball_vcount, 
-                             ball_edges, ball_ecount, 1.5f);
-        } 
-        
-        else if (demo_phase == 3) {
-            mat4_t ball_model = mat4_rotate_xyz(angle * 0.7f, angle, angle * 0.3f);
-            mat4_t ball_mvp = mat4_mul(mat4_mul(proj, view), ball_model);
-            render_wireframe(canvas, ball_mvp, ball_verts, ball_vcount, 
-                             ball_edges, ball_ecount, 1.5f);
-
-            mat4_t cube2_model = mat4_translate(-2.0f, 0.0f, -4);
-            cube2_model = mat4_mul(cube2_model, mat4_rotate_xyz(angle * 1.2f, angle * 0.8f, angle * 0.4f));
-            mat4_t cube2_mvp = mat4_mul(mat4_mul(proj, view), cube2_model);
-            render_wireframe(canvas, cube2_mvp, cube_verts, cube_vcount,
-                             cube_edges, cube_ecount, 1.2f);
-        }
+        render_demo_phase(canvas, demo_phase, angle, &models, &render_opts);
 
-#ifdef _WIN32
-        system("cls");
-#else
-        system("clear");
-#endif
-        
         if (demo_phase == 0) {
-            printf("=== Task 1: Clock-like Line Demo ===\n");
-        } else if (demo_phase == 1) {
-            printf("=== Task 2: 3D Cube Transformation Demo ===\n");
+            presenter_text(&presenter, 1, "=== Task 1: Clock-like Line Demo ===");
         } else if (demo_phase == 2) {
-            printf("=== Task 3: Rotating Soccer Ball Wireframe ===\n");
+            presenter_text(&presenter, 1, "=== Task 3: Rotating Soccer Ball Wireframe ===");
         } else if (demo_phase == 3) {
-            printf("=== Task 4: Lit & Animated Scene ===\n");
+            presenter_text(&presenter, 1, "=== Task 4: Lit & Animated Scene ===");
         }
 
-        for (int y = 0; y < 40; y++) {
-            for (int x = 0; x < 40; x++) {
-                float px = x * WIDTH / 40.0f;
-                float py = y * HEIGHT / 40.0f;
-                float b = canvas->pixels[(int)py][(int)px];
-                printf(b > 0.8f ? "##" : b > 0.5f ? "++" : b > 0.2f ? ".." : "  ");
-            }
-            printf("\n");
-        }
-        
-        printf("\nTime: %.1fs | Angle: %.1f° | Phase: %d/%d\n", time, angle * 180 / M_PI, demo_phase + 1, NUM_PHASES);
-        printf("Press Q to quit, SPACE to change task\n");
+        snprintf(status, sizeof(status), "Time: %.1fs | Angle: %.1f° | Phase: %d/%d",
+                 time, angle * 180 / M_PI, demo_phase + 1, NUM_PHASES);
+        presenter_text(&presenter, 43, status);
+        presenter_text(&presenter, 44, "Press Q to quit, SPACE to change task");
+        presenter_present(&presenter, canvas);
 
         if (kbhit()) {
 #ifdef _WIN32
@@ -229,7 +326,10 @@ int main() {
             char c = getchar();
 #endif
             if (c == 'q' || c == 'Q') break;
-            if (c == ' ') demo_phase = (demo_phase + 1) % NUM_PHASES;
+            if (c == ' ') {
+                demo_phase = (demo_phase + 1) % NUM_PHASES;
+                presenter_clear_screen(&presenter);
+            }
         }
 
         angle += 0.01f;
@@ -241,8 +341,10 @@ int main() {
 #endif
     }
     
-    free(ball_verts);
-    free(ball_edges);
+    presenter_free(&presenter);
+    arena_free(&frame_arena);
+    free(models.ball_verts);
+    free(models.ball_edges);
     free(cube_verts);
     free(cube_edges);
     free_canvas(canvas);
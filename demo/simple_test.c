@@ -2,6 +2,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
+#include <string.h>
+#include <limits.h>
 
 int main() {
     printf("=== libtiny3d Simple Test ===\n");
@@ -9,10 +11,157 @@ int main() {
     // Test 1: Canvas creation
     canvas_t* canvas = create_canvas(100, 100);
     printf("✓ Canvas created: %dx%d\n", canvas->width, canvas->height);
-    
+
+    // Test 1b: Contiguous aligned storage with compatible row pointers
+    if (((uintptr_t)canvas->data % CANVAS_ALIGNMENT) != 0 ||
+        canvas->pixels[99] != canvas->data + 99 * canvas->stride) {
+        printf("✗ Canvas storage layout is wrong\n");
+        return 1;
+    }
+    printf("✓ Canvas storage: one block, stride %d\n", canvas->stride);
+
+    // Test 1c: Every SIMD kernel matches the scalar reference
+    {
+        float src[203], ref_f[203], out_f[203];
+        uint8_t ref_q[203], out_q[203];
+        uint16_t ref_w[203], out_w[203];
+        for (int i = 0; i < 203; i++) src[i] = (i % 37) / 30.0f - 0.1f;
+        // NaN maps to 0 on every path, in vector bodies and scalar tails alike
+        src[5] = src[201] = NAN;
+        src[100] = -NAN;
+        src[6] = INFINITY;
+
+        simd_force_isa(TINY3D_ISA_SCALAR);
+        simd_scale_clamp_f32(ref_f, src, 203, 0.9f);
+        simd_quantize_u8(ref_q, src, 203);
+        simd_quantize_u16(ref_w, src, 203);
+        if (ref_f[5] != 0.0f || ref_f[100] != 0.0f || ref_q[201] != 0 || ref_w[5] != 0 || ref_q[6] != 255) {
+            printf("✗ Scalar kernels mishandle NaN or infinity\n");
+            return 1;
+        }
+
+        tiny3d_isa_t best = simd_detect_isa();
+        for (int isa = TINY3D_ISA_SSE2; isa <= best; isa++) {
+            simd_force_isa((tiny3d_isa_t)isa);
+            simd_fill_f32(out_f, 203, 0.25f);
+            simd_scale_clamp_f32(out_f, src, 203, 0.9f);
+            simd_quantize_u8(out_q, src, 203);
+            simd_quantize_u16(out_w, src, 203);
+            if (memcmp(out_f, ref_f, sizeof(ref_f)) != 0 || memcmp(out_q, ref_q, sizeof(ref_q)) != 0 ||
+                memcmp(out_w, ref_w, sizeof(ref_w)) != 0) {
+                printf("✗ %s kernels differ from scalar\n", simd_isa_name((tiny3d_isa_t)isa));
+                return 1;
+            }
+        }
+        simd_force_isa(best);
+        clear_canvas(canvas, 0.0f);
+        printf("✓ SIMD kernels match scalar (dispatch: %s)\n", simd_isa_name(simd_active_isa()));
+    }
+
     // Test 2: Draw a simple line
     draw_line_f(canvas, 10, 10, 90, 90, 2.0f);
+    if (*canvas_pixel(canvas, 50, 50) != 1.0f || *canvas_pixel(canvas, 50, 53) != 0.0f ||
+        *canvas_pixel(canvas, 9, 9) <= 0.0f || *canvas_pixel(canvas, 7, 7) != 0.0f) {
+        printf("✗ Line coverage is wrong\n");
+        return 1;
+    }
     printf("✓ Line drawn\n");
+
+    // Test 2a: Lines without a positive thickness draw nothing
+    {
+        canvas_t* c = create_canvas(20, 20);
+        float thicknesses[] = { 0.0f, -2.0f, NAN };
+        int drawn = 0;
+        for (int i = 0; i < 3; i++) {
+            draw_line_f(c, 2, 10, 18, 10, thicknesses[i]);
+            line_desc_t line = {0};
+            line.x0 = 2; line.y0 = 5; line.x1 = 18; line.y1 = 15;
+            line.thickness = thicknesses[i];
+            drawn += draw_line_desc(c, &line, 0, 0, 20, 20);
+        }
+        for (int y = 0; y < 20; y++) {
+            for (int x = 0; x < 20; x++) drawn += *canvas_pixel(c, x, y) != 0.0f;
+        }
+        free_canvas(c);
+        if (drawn) {
+            printf("✗ Zero-thickness line drew %d pixels\n", drawn);
+            return 1;
+        }
+        printf("✓ Zero and negative thickness draw nothing\n");
+    }
+
+    // Test 2b: Compact formats draw the same lines as float, within one quantization step
+    {
+        canvas_format_t formats[] = { CANVAS_UNORM16, CANVAS_UNORM8 };
+        uint8_t ref[64 * 48], out[64 * 48];
+        canvas_t* f = create_canvas(61, 48);
+        for (int i = 0; i < 2; i++) {
+            canvas_t* c = create_canvas_format(61, 48, formats[i]);
+            canvas_t* targets[] = { f, c };
+            for (int t = 0; t < 2; t++) {
+                clear_canvas(targets[t], 0.1f);
+                fill_canvas_rect(targets[t], 40, 30, 10, 10, 0.5f);
+                draw_line_f(targets[t], 3, 4, 57, 41, 2.5f);
+                draw_line_f(targets[t], 3, 40, 50, 2, 1.0f);
+                set_pixel_f(targets[t], 20.25f, 30.5f, 0.75f);
+                resolve_canvas(targets[t], 0.9f);
+            }
+            canvas_to_u8(f, ref, 64);
+            canvas_to_u8(c, out, 64);
+            int worst = 0;
+            for (int y = 0; y < 48; y++) {
+                for (int x = 0; x < 61; x++) {
+                    int d = abs(ref[y * 64 + x] - out[y * 64 + x]);
+                    if (d > worst) worst = d;
+                }
+            }
+            size_t row_bytes = (size_t)c->stride * canvas_format_size(c->format);
+            int ok = c->data == NULL && row_bytes % CANVAS_ALIGNMENT == 0 &&
+                     row_bytes == (formats[i] == CANVAS_UNORM8 ? 64u : 128u) &&
+                     fabsf(canvas_get(c, 45, 35) - canvas_get(f, 45, 35)) < 1.0f / 255.0f &&
+                     worst <= 1;
+            free_canvas(c);
+            if (!ok) {
+                printf("✗ Format %d differs from float (max %d)\n", (int)formats[i], worst);
+                return 1;
+            }
+        }
+        free_canvas(f);
+        printf("✓ unorm16 and unorm8 canvases match float rendering\n");
+    }
+
+    // Test 2c: Blend modes: deferred add saturates at resolve, max ignores draw order
+    {
+        canvas_t* a = create_canvas(40, 40);
+        canvas_t* b = create_canvas(40, 40);
+        a->blend = CANVAS_BLEND_ADD;
+        draw_line_f(a, 5, 20, 35, 20, 3.0f);
+        draw_line_f(a, 5, 20, 35, 20, 3.0f);
+        int ok = *canvas_pixel(a, 20, 20) == 2.0f;
+        resolve_canvas(a, 1.0f);
+        ok = ok && *canvas_pixel(a, 20, 20) == 1.0f;
+
+        a->blend = b->blend = CANVAS_BLEND_MAX;
+        clear_canvas(a, 0.0f);
+        draw_line_f(a, 5, 5, 35, 30, 1.5f);
+        draw_line_f(a, 5, 30, 35, 8, 4.0f);
+        draw_line_f(b, 5, 30, 35, 8, 4.0f);
+        draw_line_f(b, 5, 5, 35, 30, 1.5f);
+        ok = ok && memcmp(a->data, b->data, canvas_size(a) * sizeof(float)) == 0;
+
+        b->blend = CANVAS_BLEND_REPLACE;
+        clear_canvas(b, 0.5f);
+        draw_line_f(b, 5, 20, 35, 20, 2.5f);
+        ok = ok && *canvas_pixel(b, 20, 20) == 1.0f && *canvas_pixel(b, 20, 10) == 0.5f &&
+             *canvas_pixel(b, 20, 21) == 0.75f;
+        free_canvas(a);
+        free_canvas(b);
+        if (!ok) {
+            printf("✗ Blend modes are wrong\n");
+            return 1;
+        }
+        printf("✓ Blend modes: deferred add, max, replace\n");
+    }
     
     // Test 3: Math3D operations
     vec3_t v = vec3_from_spherical(5.0f, M_PI/4, M_PI/3);
@@ -22,6 +171,204 @@ int main() {
     vec3_t vt = mat4_mul_vec3(trans, v);
     printf("✓ Matrix transform: (%.2f, %.2f, %.2f)\n", vt.x, vt.y, vt.z);
     
+    // Test 3b: Batched transform agrees with project_vertex on every ISA
+    {
+        enum { N = 37 };
+        float xs[N], ys[N], zs[N], ref_x[N], ref_y[N], out_x[N], out_y[N], out_z[N];
+        mat4_t mvp = mat4_mul(mat4_mul(mat4_frustum_asymmetric(-1, 1, -1, 1, 1, 100),
+                                       mat4_translate(0, 0, -6)),
+                              mat4_rotate_xyz(0.3f, 0.2f, 0.1f));
+        for (int i = 0; i < N; i++) {
+            xs[i] = sinf(i * 1.3f);
+            ys[i] = cosf(i * 0.7f);
+            zs[i] = sinf(i * 0.4f) * 2.0f;
+        }
+        tiny3d_isa_t best = simd_detect_isa();
+        simd_force_isa(TINY3D_ISA_SCALAR);
+        transform_points_soa(&mvp, xs, ys, zs, N, 200.0f, 100.0f, ref_x, ref_y, NULL, NULL);
+        for (int isa = TINY3D_ISA_SSE2; isa <= best; isa++) {
+            simd_force_isa((tiny3d_isa_t)isa);
+            transform_points_soa(&mvp, xs, ys, zs, N, 200.0f, 100.0f, out_x, out_y, out_z, NULL);
+            if (memcmp(out_x, ref_x, sizeof(ref_x)) != 0 || memcmp(out_y, ref_y, sizeof(ref_y)) != 0) {
+                printf("✗ %s batch transform differs from scalar\n", simd_isa_name((tiny3d_isa_t)isa));
+                return 1;
+            }
+        }
+        simd_force_isa(best);
+        for (int i = 0; i < N; i++) {
+            vec3_t p = {xs[i], ys[i], zs[i]};
+            float sx, sy;
+            project_vertex(mvp, p, &sx, &sy);
+            if (fabsf(sx * 200.0f - out_x[i]) > 1e-3f || fabsf(sy * 100.0f - out_y[i]) > 1e-3f) {
+                printf("✗ Batch transform disagrees with project_vertex\n");
+                return 1;
+            }
+        }
+        printf("✓ Batched transform matches project_vertex\n");
+    }
+
+    // Test 3c: Batched light set matches compute_lighting, identically on every ISA
+    {
+        light_t lights[MAX_LIGHTS];
+        int light_count = 0;
+        light_set_t set;
+        light_set_init(&set);
+        vec3_t dirs[3] = { { 1, 1, 1 }, { -2, 0.5f, 0 }, { 0, -1, 3 } };
+        for (int i = 0; i < 3; i++) {
+            add_light(lights, &light_count, dirs[i], 0.3f + 0.2f * i);
+            light_set_add(&set, dirs[i], 0.3f + 0.2f * i);
+        }
+
+        enum { N = 203 };
+        float nx[N], ny[N], nz[N], ref[N], out[N];
+        for (int i = 0; i < N; i++) {
+            nx[i] = sinf(i * 0.7f) * 3.0f;
+            ny[i] = cosf(i * 1.3f);
+            nz[i] = i % 50 == 0 ? 0.0f : sinf(i * 0.2f) - 0.5f;
+        }
+        nx[0] = ny[0] = 0.0f;  // Zero normal
+        tiny3d_isa_t best = simd_active_isa();
+        simd_force_isa(TINY3D_ISA_SCALAR);
+        light_set_shade_soa(&set, nx, ny, nz, N, ref);
+        int ok = ref[0] == 0.0f;
+        for (int i = 0; i < N && ok; i++) {
+            float expected = compute_lighting((vec3_t){ nx[i], ny[i], nz[i] }, lights, light_count);
+            ok = fabsf(ref[i] - expected) < 5e-3f;
+        }
+        for (int isa = TINY3D_ISA_SSE2; isa <= best && ok; isa++) {
+            simd_force_isa((tiny3d_isa_t)isa);
+            light_set_shade_soa(&set, nx, ny, nz, N, out);
+            ok = memcmp(out, ref, sizeof(ref)) == 0;
+        }
+        simd_force_isa(best);
+
+        vec3_t fan[4] = { { 0, 0, 0 }, { 2, 1, 0 }, { -1, 3, 1 }, { 0, -2, 5 } };
+        int fan_edges[] = { 0, 1, 0, 2, 0, 3, 1, 2, 2, 3, 3, 1 };
+        float edge_out[6];
+        light_set_shade_edges(&set, fan, fan_edges, 6, edge_out);
+        for (int e = 0; e < 6 && ok; e++) {
+            float expected = calculate_edge_lighting(fan[fan_edges[2 * e]], fan[fan_edges[2 * e + 1]],
+                                                     lights, light_count);
+            ok = fabsf(edge_out[e] - expected) < 5e-3f;
+        }
+        if (!ok) {
+            printf("✗ Light set shading is wrong\n");
+            return 1;
+        }
+        printf("✓ Light set shades %d normals in one batch\n", N);
+    }
+
+    // Test 3d: Fast trig stays within its error bounds, identically on every ISA
+    {
+        enum { N = 1001 };
+        static float x[N], y[N], ref[4][N], out[4][N];
+        for (int i = 0; i < N; i++) {
+            x[i] = -1.0f + 2.0f * i / (N - 1);
+            y[i] = sinf(i * 0.37f) * 5.0f;
+        }
+        float bounds[2][3] = { { 2e-7f, 5e-7f, 5e-7f }, { 2e-5f, 5e-5f, 2e-5f } };
+        tiny3d_isa_t best = simd_active_isa();
+        int ok = 1;
+        for (int acc = TRIG_ACCURATE; acc <= TRIG_FAST && ok; acc++) {
+            simd_force_isa(TINY3D_ISA_SCALAR);
+            trig_sincos_n(y, ref[0], ref[1], N, (trig_accuracy_t)acc);
+            trig_acos_n(x, ref[2], N, (trig_accuracy_t)acc);
+            trig_atan2_n(y, x, ref[3], N, (trig_accuracy_t)acc);
+            for (int i = 0; i < N && ok; i++) {
+                ok = fabs(ref[0][i] - sin(y[i])) <= bounds[acc][0] && fabs(ref[1][i] - cos(y[i])) <= bounds[acc][0] &&
+                     fabs(ref[2][i] - acos(x[i])) <= bounds[acc][1] &&
+                     fabs(ref[3][i] - atan2(y[i], x[i])) <= bounds[acc][2];
+            }
+            for (int isa = TINY3D_ISA_SSE2; isa <= best && ok; isa++) {
+                simd_force_isa((tiny3d_isa_t)isa);
+                trig_sincos_n(y, out[0], out[1], N, (trig_accuracy_t)acc);
+                trig_acos_n(x, out[2], N, (trig_accuracy_t)acc);
+                trig_atan2_n(y, x, out[3], N, (trig_accuracy_t)acc);
+                ok = memcmp(out, ref, sizeof(ref)) == 0;
+            }
+        }
+        simd_force_isa(best);
+
+        // Past the reduction range, and for inf and NaN, sincos matches libm on every ISA
+        float far[16] = { 1e6f, -1e6f, 8192.0f, -3e9f, 1e10f, 0.5f, INFINITY, -INFINITY,
+                          NAN, 8191.5f, -2.0f, 3e38f, -8192.0f, 1.0f, 4096.0f, 70000.0f };
+        float far_ref[2][16], far_out[2][16];
+        simd_force_isa(TINY3D_ISA_SCALAR);
+        trig_sincos_n(far, far_ref[0], far_ref[1], 16, TRIG_ACCURATE);
+        for (int i = 0; i < 16 && ok; i++) {
+            if (fabsf(far[i]) < 8192.0f) continue;
+            ok = isfinite(far[i]) ? far_ref[0][i] == sinf(far[i]) && far_ref[1][i] == cosf(far[i])
+                                  : isnan(far_ref[0][i]) && isnan(far_ref[1][i]);
+        }
+        ok = ok && fabsf(far_ref[0][0] - (float)sin(1e6)) <= 2e-7f;
+        for (int isa = TINY3D_ISA_SSE2; isa <= best && ok; isa++) {
+            simd_force_isa((tiny3d_isa_t)isa);
+            trig_sincos_n(far, far_out[0], far_out[1], 16, TRIG_ACCURATE);
+            ok = memcmp(far_out, far_ref, sizeof(far_ref)) == 0;
+        }
+        simd_force_isa(best);
+
+        // The closed-form rotation equals the product of the three axis rotations
+        mat4_t r = mat4_rotate_xyz(0.3f, 1.1f, -2.0f);
+        mat4_t composed = mat4_mul(mat4_mul(mat4_rotate_xyz(0, 0, -2.0f), mat4_rotate_xyz(0, 1.1f, 0)),
+                                   mat4_rotate_xyz(0.3f, 0, 0));
+        for (int c = 0; c < 4 && ok; c++) {
+            for (int row = 0; row < 4 && ok; row++) ok = fabsf(r.m[c][row] - composed.m[c][row]) < 1e-6f;
+        }
+        if (!ok) {
+            printf("✗ Fast trig is out of bounds or differs between ISAs\n");
+            return 1;
+        }
+        printf("✓ Fast trig within bounds, closed-form rotation matches\n");
+    }
+
+    // Test 3e: Quaternions match the matrix conventions; batched slerp matches single calls
+    {
+        quat_t qa = quat_from_euler_xyz(0.3f, 1.1f, -2.0f);
+        quat_t qb = quat_from_axis_angle((vec3_t){1, 2, -1}, 2.5f);
+        mat4_t ma = quat_to_mat4(qa), mb = quat_to_mat4(qb);
+        mat4_t euler = mat4_rotate_xyz(0.3f, 1.1f, -2.0f);
+        mat4_t both = mat4_mul(ma, mb), qboth = quat_to_mat4(quat_mul(qa, qb));
+        int ok = 1;
+        for (int c = 0; c < 4 && ok; c++) {
+            for (int row = 0; row < 4 && ok; row++) {
+                ok = fabsf(ma.m[c][row] - euler.m[c][row]) < 1e-5f && fabsf(both.m[c][row] - qboth.m[c][row]) < 1e-5f;
+            }
+        }
+        vec3_t p = {0.5f, -1.0f, 2.0f};
+        vec3_t by_quat = quat_rotate_vec3(qb, p), by_mat = mat4_mul_vec3(mb, p);
+        ok = ok && fabsf(by_quat.x - by_mat.x) < 1e-5f && fabsf(by_quat.y - by_mat.y) < 1e-5f &&
+             fabsf(by_quat.z - by_mat.z) < 1e-5f;
+
+        // Halfway between 0 and 90 degrees about Z is 45 degrees
+        quat_t half = quat_slerp(quat_identity(), quat_from_axis_angle((vec3_t){0, 0, 1}, (float)M_PI_2), 0.5f);
+        quat_t expect = quat_from_axis_angle((vec3_t){0, 0, 1}, (float)M_PI_4);
+        ok = ok && fabsf(half.z - expect.z) < 1e-6f && fabsf(half.w - expect.w) < 1e-6f;
+
+        enum { N = 1000 };
+        static float a[4][N], b[4][N], t[N], o[4][N];
+        for (int i = 0; i < N; i++) {
+            quat_t q0 = quat_from_euler_xyz(i * 0.01f, i * 0.02f, -i * 0.03f);
+            quat_t q1 = quat_from_axis_angle((vec3_t){sinf(i), 1, cosf(i)}, i * 0.05f - 3.0f);
+            if (i % 100 == 0) q1 = q0;  // Identical ends take the linear path
+            a[0][i] = q0.x; a[1][i] = q0.y; a[2][i] = q0.z; a[3][i] = q0.w;
+            b[0][i] = q1.x; b[1][i] = q1.y; b[2][i] = q1.z; b[3][i] = q1.w;
+            t[i] = (i % 11) / 10.0f;
+        }
+        quat_soa_t sa = {a[0], a[1], a[2], a[3]}, sb = {b[0], b[1], b[2], b[3]}, so = {o[0], o[1], o[2], o[3]};
+        quat_slerp_n(&sa, &sb, t, &so, N);
+        for (int i = 0; i < N && ok; i++) {
+            quat_t q = quat_slerp((quat_t){a[0][i], a[1][i], a[2][i], a[3][i]},
+                                  (quat_t){b[0][i], b[1][i], b[2][i], b[3][i]}, t[i]);
+            ok = q.x == o[0][i] && q.y == o[1][i] && q.z == o[2][i] && q.w == o[3][i];
+        }
+        if (!ok) {
+            printf("✗ Quaternion results are wrong\n");
+            return 1;
+        }
+        printf("✓ Quaternions compose like mat4_mul, %d slerps in one batch\n", N);
+    }
+
     // Test 4: Create cube
     vec3_t *cube_verts;
     int *cube_edges;
@@ -29,7 +376,521 @@ int main() {
     
     create_cube(&cube_verts, &cube_edges, &cube_vcount, &cube_ecount);
     printf("✓ Cube created: %d vertices, %d edges\n", cube_vcount, cube_ecount);
-    
+
+    // Test 4a: OBJ import shares edges between faces and survives a binary round trip
+    {
+        FILE* f = fopen("build/test_cube.obj", "w");
+        if (f) {
+            fputs("# unit cube, quads with texture/normal indices\n"
+                  "v -1 -1 -1\nv 1 -1 -1\nv 1 1 -1\nv -1 1 -1\n"
+                  "v -1 -1 1\nv 1 -1 1\nv 1 1 1\nv -1 1 1\n"
+                  "f 1/1/1 2/2/1 3/3/1 4/4/1\nf 5 6 7 8\nf 1 2 6 5\n"
+                  "f -5 -6 -2 -1\nf 2 3 7 6\nf 1 4 8 5\nl 1 2\n", f);
+            fclose(f);
+        }
+        mesh_t obj, mapped;
+        int ok = mesh_load_obj("build/test_cube.obj", &obj) == 0 &&
+                 obj.vertex_count == 8 && obj.edge_count == 12;
+        ok = ok && mesh_save_binary("build/test_cube.t3dm", &obj) == 0 &&
+             mesh_map_binary("build/test_cube.t3dm", &mapped) == 0;
+        if (ok) {
+            ok = mapped.vertex_count == 8 && mapped.edge_count == 12 &&
+                 ((uintptr_t)mapped.vertices % 64) == 0 &&
+                 memcmp(mapped.vertices, obj.vertices, 8 * sizeof(vec3_t)) == 0 &&
+                 memcmp(mapped.edges, obj.edges, 24 * sizeof(int)) == 0;
+            mesh_free(&mapped);
+        }
+        mesh_free(&obj);
+        remove("build/test_cube.obj");
+        remove("build/test_cube.t3dm");
+        if (!ok) {
+            printf("✗ Mesh import or binary round trip failed\n");
+            return 1;
+        }
+        printf("✓ OBJ import deduplicates edges, binary mesh maps in place\n");
+    }
+
+    // Test 4a2: Binary headers whose sections wrap or overlap are rejected
+    {
+        mesh_binary_header_t h;
+        memset(&h, 0, sizeof(h));
+        memcpy(h.magic, MESH_BINARY_MAGIC, 4);
+        h.version = MESH_BINARY_VERSION;
+        h.byte_order = 0x01020304u;
+        h.vertex_count = 6;
+        h.edge_count = 1;
+        h.vertex_offset = 0xFFFFFFFFFFFFFFC0ull;  // Plus 72 bytes wraps to 8
+        h.edge_offset = 64;
+
+        unsigned char file[128];
+        memset(file, 0, sizeof(file));
+        memcpy(file, &h, sizeof(h));
+        int wrapped = -1, overlapping = -1;
+        FILE* f = fopen("build/test_bad.t3dm", "wb");
+        if (f) {
+            fwrite(file, 1, sizeof(file), f);
+            fclose(f);
+            mesh_t mesh;
+            wrapped = mesh_map_binary("build/test_bad.t3dm", &mesh);
+            if (wrapped == 0) mesh_free(&mesh);
+        }
+
+        // Edge section lying inside the vertex section
+        h.vertex_offset = 64;
+        h.edge_offset = 64;
+        memcpy(file, &h, sizeof(h));
+        f = fopen("build/test_bad.t3dm", "wb");
+        if (f) {
+            fwrite(file, 1, sizeof(file), f);
+            fclose(f);
+            mesh_t mesh;
+            overlapping = mesh_map_binary("build/test_bad.t3dm", &mesh);
+            if (overlapping == 0) mesh_free(&mesh);
+        }
+        remove("build/test_bad.t3dm");
+        if (wrapped != -1 || overlapping != -1) {
+            printf("✗ Malformed binary mesh was mapped\n");
+            return 1;
+        }
+        printf("✓ Wrapped and overlapping mesh sections are rejected\n");
+    }
+
+    // Test 4b: Frame arena folds overflow chunks into one on reset
+    {
+        unsigned char buffer[256];
+        arena_t arena;
+        arena_init(&arena, buffer, sizeof(buffer));
+        double* small = ARENA_ALLOC(&arena, double, 4);
+        void* big = arena_alloc(&arena, 100000, 64);
+        void* bigger = arena_alloc(&arena, 300000, 64);
+        int ok = (unsigned char*)small >= buffer && (unsigned char*)small < buffer + sizeof(buffer) &&
+                 ((uintptr_t)big % 64) == 0 && bigger != NULL;
+        arena_reset(&arena);
+        ok = ok && arena.chunks && !arena.chunks->next && arena.size >= 400000;
+        // Chunk payloads start on a cache line even for byte-aligned requests
+        ok = ok && ((uintptr_t)arena_alloc(&arena, 1, 1) % 64) == 0;
+        // Scratch that overflows between a mark and a rewind reuses the same chunk every time
+        arena_chunk_t* first_scratch = NULL;
+        for (int batch = 0; batch < 8 && ok; batch++) {
+            arena_mark_t mark = arena_mark(&arena);
+            ok = arena_alloc(&arena, arena.size, 64) != NULL;
+            if (batch == 0) first_scratch = arena.chunks;
+            ok = ok && arena.chunks == first_scratch && arena.chunks->next != NULL;
+            arena_rewind(&arena, mark);
+            ok = ok && arena.spare == first_scratch && !arena.spare->next;
+        }
+        arena_free(&arena);
+        if (!ok) {
+            printf("✗ Frame arena misbehaved\n");
+            return 1;
+        }
+        printf("✓ Frame arena reuses one block after reset and its scratch chunks after rewind\n");
+    }
+
+    // Test 4c: Edges crossing the near plane are clipped, not flipped
+    {
+        vec3_t verts[2] = {{0.0f, 0.0f, -5.0f}, {3.0f, 0.0f, 10.0f}};  // Second one is behind the camera
+        int edge[2] = {0, 1};
+        mat4_t proj = mat4_frustum_asymmetric(-1, 1, -1, 1, 1, 100);
+        canvas_t* c = create_canvas(64, 64);
+        render_wireframe(c, proj, verts, 2, edge, 1, 1.0f);
+        float lit = 0.0f;
+        int finite = 1;
+        for (int y = 0; y < c->height; y++) {
+            for (int x = 0; x < c->width; x++) {
+                float p = *canvas_pixel(c, x, y);
+                finite = finite && isfinite(p);
+                lit += p;
+            }
+        }
+        // The visible half runs from the center towards +x only
+        int ok = finite && lit > 0.0f && *canvas_pixel(c, 40, 32) > 0.0f && *canvas_pixel(c, 26, 32) == 0.0f;
+        free_canvas(c);
+        if (!ok) {
+            printf("✗ Near-plane clipping is wrong\n");
+            return 1;
+        }
+        printf("✓ Near-plane clipping keeps only the visible part\n");
+    }
+
+    // Test 4d: Depth-tested mode hides a far edge drawn after a near one
+    {
+        vec3_t verts[4] = {{-1.0f, 0.0f, -3.0f}, {1.0f, 0.0f, -3.0f},   // Near, horizontal
+                           {0.0f, -2.0f, -6.0f}, {0.0f, 2.0f, -6.0f}};  // Far, vertical
+        int edges[4] = {0, 1, 2, 3};
+        mat4_t proj = mat4_frustum_asymmetric(-1, 1, -1, 1, 1, 100);
+        canvas_t* c = create_canvas(64, 64);
+        z_buffer_t zbuf;
+        init_z_buffer(&zbuf, 64, 64);
+        render_options_t opts = {0};
+        opts.zbuf = &zbuf;
+
+        render_wireframe_ex(c, proj, verts, 4, edges, 1, 1.0f, &opts);
+        clear_canvas(c, 0.0f);
+        render_wireframe_ex(c, proj, verts, 4, edges + 2, 1, 1.0f, &opts);
+        float crossing = *canvas_pixel(c, 32, 32);
+        float far_only = *canvas_pixel(c, 32, 40);
+
+        free_z_buffer(&zbuf);
+
+        // A depth buffer too big to allocate comes back empty and is ignored
+        z_buffer_t huge;
+        init_z_buffer(&huge, INT_MAX, INT_MAX);
+        int empty = !huge.buffer && !huge.hiz && !huge.hiz_dirty && !z_buffer_test(&huge, 1, 1, 0.5f);
+        opts.zbuf = &huge;
+        clear_canvas(c, 0.0f);
+        render_wireframe_ex(c, proj, verts, 4, edges, 2, 1.0f, &opts);
+        empty = empty && *canvas_pixel(c, 32, 40) == 1.0f;
+        free_z_buffer(&huge);
+        free_canvas(c);
+        if (crossing != 0.0f || far_only != 1.0f || !empty) {
+            printf("✗ Depth-tested rendering is wrong\n");
+            return 1;
+        }
+        printf("✓ Depth-tested lines hide occluded pixels\n");
+    }
+
+    // Test 4d2: Lit mode scales edges by their lighting, per edge or interpolated per vertex
+    {
+        vec3_t verts[2] = {{-0.5f, 0.0f, 0.0f}, {0.5f, 0.0f, 0.0f}};
+        int edges[2] = {0, 1};
+        canvas_t* c = create_canvas(64, 64);
+        light_set_t below, left;
+        light_set_init(&below);
+        light_set_add(&below, (vec3_t){0, -1, 0}, 0.5f);  // Along the edge's perpendicular
+        light_set_init(&left);
+        light_set_add(&left, (vec3_t){-1, 0, 0}, 1.0f);   // Facing the first vertex only
+        render_options_t opts = {0};
+
+        opts.lights = &below;
+        opts.lighting = RENDER_LIGHT_EDGE;
+        render_wireframe_ex(c, mat4_identity(), verts, 2, edges, 1, 3.0f, &opts);
+        int ok = *canvas_pixel(c, 20, 32) == 0.5f && *canvas_pixel(c, 44, 32) == 0.5f;
+
+        clear_canvas(c, 0.0f);
+        opts.lights = &left;
+        opts.lighting = RENDER_LIGHT_VERTEX;
+        render_wireframe_ex(c, mat4_identity(), verts, 2, edges, 1, 3.0f, &opts);
+        float start = *canvas_pixel(c, 16, 32), middle = *canvas_pixel(c, 32, 32), end = *canvas_pixel(c, 48, 32);
+        ok = ok && start == 1.0f && fabsf(middle - 0.5f) < 1e-5f && end == 0.0f;
+
+        free_canvas(c);
+        if (!ok) {
+            printf("✗ Lit wireframe intensities are wrong\n");
+            return 1;
+        }
+        printf("✓ Lit wireframe: per-edge and interpolated per-vertex intensity\n");
+    }
+
+    // Test 4e: Scene culling draws the same image as drawing every model
+    {
+        enum { GRID = 15 };
+        scene_t scene;
+        scene_init(&scene);
+        for (int i = 0; i < GRID * GRID; i++) {
+            mat4_t model = mat4_translate((i % GRID - GRID / 2) * 3.0f, (i / GRID - GRID / 2) * 3.0f,
+                                          -8.0f - (i % 3) * 4.0f);
+            scene_add_model(&scene, cube_verts, cube_vcount, cube_edges, cube_ecount, model);
+        }
+        mat4_t view_proj = mat4_frustum_asymmetric(-1, 1, -1, 1, 1, 100);
+        canvas_t* culled = create_canvas(120, 120);
+        canvas_t* brute = create_canvas(120, 120);
+
+        int ok = 1, drawn = 0;
+        for (int frame = 0; frame < 2 && ok; frame++) {
+            if (frame == 1) scene_set_transform(&scene, GRID * GRID / 2, mat4_translate(4.0f, 1.0f, -6.0f));
+            clear_canvas(culled, 0.0f);
+            clear_canvas(brute, 0.0f);
+            drawn = scene_render(&scene, culled, view_proj, 1.5f, NULL);
+            for (int i = 0; i < scene.model_count; i++) {
+                render_wireframe(brute, mat4_mul(scene.models[i].model, view_proj), cube_verts, cube_vcount,
+                                 cube_edges, cube_ecount, 1.5f);
+            }
+            ok = drawn > 0 && drawn < GRID * GRID &&
+                 memcmp(culled->data, brute->data, canvas_size(culled) * sizeof(float)) == 0;
+        }
+        free_canvas(brute);
+        free_canvas(culled);
+        scene_free(&scene);
+        if (!ok) {
+            printf("✗ Scene culling changed the image\n");
+            return 1;
+        }
+        printf("✓ Scene culling draws %d of %d models, same image\n", drawn, GRID * GRID);
+    }
+
+    // Test 4f: Instanced rendering matches one call per instance, across batch flushes
+    {
+        enum { INSTANCES = 6000 };  // 72000 edges: more than one batch
+        mat4_t* models = (mat4_t*)malloc(INSTANCES * sizeof(mat4_t));
+        srand(11);
+        for (int i = 0; i < INSTANCES; i++) {
+            models[i] = mat4_mul(mat4_scale(0.3f, 0.3f, 0.3f),
+                                 mat4_translate(rand() / (float)RAND_MAX * 16.0f - 8.0f,
+                                                rand() / (float)RAND_MAX * 16.0f - 8.0f,
+                                                -4.0f - rand() / (float)RAND_MAX * 20.0f));
+        }
+        mat4_t view_proj = mat4_frustum_asymmetric(-1, 1, -1, 1, 1, 100);
+        canvas_t* single = create_canvas(100, 100);
+        canvas_t* instanced = create_canvas(100, 100);
+        z_buffer_t zs, zi;
+        init_z_buffer(&zs, 100, 100);
+        init_z_buffer(&zi, 100, 100);
+        thread_pool_t* pool = thread_pool_create(3);
+        render_options_t single_opts = {0}, instanced_opts = {0};
+        single_opts.zbuf = &zs;
+        instanced_opts.zbuf = &zi;
+
+        int same = 1;
+        for (int pass = 0; pass < 2 && same; pass++) {
+            instanced_opts.pool = pass ? pool : NULL;
+            clear_canvas(single, 0.0f);
+            clear_canvas(instanced, 0.0f);
+            clear_z_buffer(&zs);
+            clear_z_buffer(&zi);
+            for (int i = 0; i < INSTANCES; i++) {
+                render_wireframe_ex(single, mat4_mul(models[i], view_proj), cube_verts, cube_vcount,
+                                    cube_edges, cube_ecount, 1.0f, &single_opts);
+            }
+            render_wireframe_instanced(instanced, view_proj, cube_verts, cube_vcount, cube_edges, cube_ecount,
+                                       models, INSTANCES, 1.0f, &instanced_opts);
+            same = memcmp(single->data, instanced->data, canvas_size(single) * sizeof(float)) == 0;
+        }
+
+        thread_pool_destroy(pool);
+        free_z_buffer(&zi);
+        free_z_buffer(&zs);
+        free_canvas(instanced);
+        free_canvas(single);
+        free(models);
+        if (!same) {
+            printf("✗ Instanced render differs from per-instance calls\n");
+            return 1;
+        }
+        printf("✓ Instanced render matches per-instance calls (%d instances)\n", INSTANCES);
+    }
+
+    // Test 4g: The terminal presenter only resends cells that changed
+    {
+        FILE* sink = tmpfile();
+        canvas_t* c = create_canvas(80, 80);
+        draw_line_f(c, 5, 5, 70, 40, 2.0f);
+        long sizes[4] = {-1, -1, -1, -1};
+        presenter_t ramp, blocks;
+        presenter_config_t cfg = {0};
+        cfg.cols = 20;
+        cfg.rows = 20;
+        cfg.fd = sink ? fileno(sink) : -1;
+        if (sink && presenter_init(&ramp, &cfg) == 0) {
+            sizes[0] = presenter_present(&ramp, c);
+            sizes[1] = presenter_present(&ramp, c);
+            set_pixel_f(c, 60, 70, 1.0f);
+            sizes[2] = presenter_present(&ramp, c);
+            presenter_free(&ramp);
+        }
+        cfg.mode = PRESENTER_HALF_BLOCK;
+        if (sink && presenter_init(&blocks, &cfg) == 0) {
+            sizes[3] = presenter_present(&blocks, c);
+            presenter_free(&blocks);
+        }
+        free_canvas(c);
+        if (sink) fclose(sink);
+        // One changed cell costs a cursor move plus two glyphs
+        if (sizes[0] < 20 * 20 * 2 || sizes[1] != 0 || sizes[2] <= 0 || sizes[2] > 16 || sizes[3] < 20 * 20 * 3) {
+            printf("✗ Presenter output sizes are wrong (%ld, %ld, %ld, %ld)\n",
+                   sizes[0], sizes[1], sizes[2], sizes[3]);
+            return 1;
+        }
+        printf("✓ Presenter sends %ld bytes, then %ld unchanged, %ld for one cell\n",
+               sizes[0], sizes[1], sizes[2]);
+    }
+
+    // Test 4h: Exported PGM holds the quantized canvas; PNG has a sane layout
+    {
+        canvas_t* c = create_canvas(37, 5);
+        for (int y = 0; y < 5; y++) {
+            for (int x = 0; x < 37; x++) *canvas_pixel(c, x, y) = (x * 5 + y) / 185.0f;
+        }
+        uint8_t expected[37 * 5];
+        canvas_to_u8(c, expected, 37);
+
+        int ok = save_canvas_to_pgm(c, "build/test_export.pgm") == 0 &&
+                 save_canvas(c, "build/test_export.png", 16) == 0;
+        unsigned char file[512];
+        size_t n = 0;
+        FILE* f = ok ? fopen("build/test_export.pgm", "rb") : NULL;
+        if (f) {
+            n = fread(file, 1, sizeof(file), f);
+            fclose(f);
+        }
+        const char* header = "P5\n37 5\n255\n";
+        size_t h = strlen(header);
+        ok = ok && n == h + sizeof(expected) && memcmp(file, header, h) == 0 &&
+             memcmp(file + h, expected, sizeof(expected)) == 0;
+
+        // Signature, IHDR, one IDAT of stored blocks, IEND
+        f = ok ? fopen("build/test_export.png", "rb") : NULL;
+        if (f) {
+            n = fread(file, 1, sizeof(file), f);
+            fclose(f);
+        }
+        size_t png_size = 8 + 25 + 12 + (2 + 5 + 5 * (1 + 37 * 2) + 4) + 12;
+        ok = ok && n == png_size && memcmp(file + 1, "PNG", 3) == 0 && memcmp(file + 12, "IHDR", 4) == 0 &&
+             file[24] == 16 && memcmp(file + 37, "IDAT", 4) == 0 && memcmp(file + n - 8, "IEND", 4) == 0;
+
+        remove("build/test_export.pgm");
+        remove("build/test_export.png");
+        free_canvas(c);
+        if (!ok) {
+            printf("✗ Image export is wrong\n");
+            return 1;
+        }
+        printf("✓ PGM and PNG export stream the quantized canvas\n");
+    }
+
+    // Test 4i: Y4M stream carries every submitted frame in order
+    {
+        FILE* sink = tmpfile();
+        canvas_t* c = create_canvas(9, 5);  // Odd size: chroma planes round up
+        video_writer_t* video = sink ? video_open_y4m(fileno(sink), 9, 5, 25) : NULL;
+        int ok = video != NULL;
+        for (int frame = 0; frame < 4 && ok; frame++) {
+            clear_canvas(c, frame / 3.0f);
+            ok = video_submit_frame(video, c) == 0;
+        }
+        ok = video && video_close(video) == 0 && ok;
+
+        const char* header = "YUV4MPEG2 W9 H5 F25:1 Ip A1:1 C420jpeg XCOLORRANGE=FULL\n";
+        size_t h = strlen(header), frame_size = 6 + 9 * 5 + 2 * 5 * 3;
+        unsigned char file[1024];
+        size_t n = 0;
+        if (sink) {
+            rewind(sink);
+            n = fread(file, 1, sizeof(file), sink);
+            fclose(sink);
+        }
+        ok = ok && n == h + 4 * frame_size && memcmp(file, header, h) == 0 &&
+             memcmp(file + h + 3 * frame_size, "FRAME\n", 6) == 0 &&
+             file[h + 6] == 0 && file[h + frame_size + 6] == 85 && file[h + 3 * frame_size + 6] == 255;
+        free_canvas(c);
+        if (!ok) {
+            printf("✗ Y4M stream is wrong\n");
+            return 1;
+        }
+        printf("✓ Y4M writer streams double-buffered frames\n");
+    }
+
+    // Test 5: Tile-parallel rendering matches the serial renderer bit for bit
+    {
+        enum { VCOUNT = 200, ECOUNT = 600 };
+        vec3_t verts[VCOUNT];
+        int edges[ECOUNT * 2];
+        srand(7);
+        for (int i = 0; i < VCOUNT; i++) {
+            verts[i].x = rand() / (float)RAND_MAX * 4.0f - 2.0f;
+            verts[i].y = rand() / (float)RAND_MAX * 4.0f - 2.0f;
+            verts[i].z = rand() / (float)RAND_MAX * 4.0f - 2.0f;
+        }
+        for (int i = 0; i < ECOUNT * 2; i++) edges[i] = rand() % VCOUNT;
+
+        mat4_t mvp = mat4_mul(mat4_mul(mat4_frustum_asymmetric(-1, 1, -1, 1, 1, 100),
+                                       mat4_translate(0, 0, -5)),
+                              mat4_rotate_xyz(0.4f, 0.9f, 0.1f));
+        canvas_t* serial = create_canvas(300, 200);
+        canvas_t* parallel = create_canvas(300, 200);
+        thread_pool_t* pool = thread_pool_create(4);
+
+        render_wireframe(serial, mvp, verts, VCOUNT, edges, ECOUNT, 1.5f);
+        for (int frame = 0; frame < 3; frame++) {
+            clear_canvas(parallel, 0.0f);
+            render_wireframe_parallel(pool, parallel, mvp, verts, VCOUNT, edges, ECOUNT, 1.5f);
+        }
+        int same = memcmp(serial->data, parallel->data, canvas_size(serial) * sizeof(float)) == 0;
+
+        // Same again in depth-tested mode, with hierarchical-Z rejection active
+        z_buffer_t zs, zp;
+        init_z_buffer(&zs, 300, 200);
+        init_z_buffer(&zp, 300, 200);
+        render_options_t serial_opts = {0}, parallel_opts = {0};
+        serial_opts.zbuf = &zs;
+        parallel_opts.zbuf = &zp;
+        parallel_opts.pool = pool;
+        clear_canvas(serial, 0.0f);
+        clear_canvas(parallel, 0.0f);
+        render_wireframe_ex(serial, mvp, verts, VCOUNT, edges, ECOUNT, 1.5f, &serial_opts);
+        render_wireframe_ex(parallel, mvp, verts, VCOUNT, edges, ECOUNT, 1.5f, &parallel_opts);
+        same = same && memcmp(serial->data, parallel->data, canvas_size(serial) * sizeof(float)) == 0;
+        free_z_buffer(&zp);
+        free_z_buffer(&zs);
+
+        thread_pool_destroy(pool);
+        free_canvas(parallel);
+        free_canvas(serial);
+        if (!same) {
+            printf("✗ Parallel render differs from serial render\n");
+            return 1;
+        }
+        printf("✓ Parallel render matches serial (%d edges)\n", ECOUNT);
+    }
+
+#ifdef TINY3D_STATS
+    // Test 5b: Frame statistics count the pipeline's work, the same serial or tiled
+    {
+        canvas_t* c = create_canvas(200, 200);
+        mat4_t mvp = mat4_mul(mat4_mul(mat4_rotate_xyz(0.5f, 0.6f, 0.0f), mat4_translate(0, 0, -4)),
+                              mat4_frustum_asymmetric(-1, 1, -1, 1, 1, 100));
+        tiny3d_stats_begin_frame();
+        clear_canvas(c, 0.0f);
+        render_wireframe(c, mvp, cube_verts, cube_vcount, cube_edges, cube_ecount, 2.0f);
+        tiny3d_stats_end_frame();
+        tiny3d_frame_stats_t serial = tiny3d_get_frame_stats();
+
+        int lit = 0;
+        for (int y = 0; y < c->height; y++) {
+            for (int x = 0; x < c->width; x++) lit += canvas_row(c, y)[x] > 0.0f;
+        }
+
+        thread_pool_t* pool = thread_pool_create(4);
+        tiny3d_stats_begin_frame();
+        clear_canvas(c, 0.0f);
+        render_wireframe_parallel(pool, c, mvp, cube_verts, cube_vcount, cube_edges, cube_ecount, 2.0f);
+        tiny3d_stats_end_frame();
+        tiny3d_frame_stats_t tiled = tiny3d_get_frame_stats();
+        thread_pool_destroy(pool);
+
+        // Work outside a frame is not counted
+        clear_canvas(c, 0.0f);
+        render_wireframe(c, mvp, cube_verts, cube_vcount, cube_edges, cube_ecount, 2.0f);
+        tiny3d_stats_begin_frame();
+        tiny3d_stats_end_frame();
+        tiny3d_frame_stats_t idle = tiny3d_get_frame_stats();
+        free_canvas(c);
+
+        const char* trace = "build/test_trace.json";
+        char head[32] = {0};
+        FILE* f = NULL;
+        if (tiny3d_stats_save_trace(trace) == 0 && (f = fopen(trace, "r"))) {
+            if (!fgets(head, sizeof(head), f)) head[0] = 0;
+            fclose(f);
+        }
+        remove(trace);
+
+        if (serial.vertices_transformed != (uint64_t)cube_vcount ||
+            serial.edges_submitted != (uint64_t)cube_ecount ||
+            serial.edges_drawn + serial.edges_culled != serial.edges_submitted ||
+            serial.pixels_written < (uint64_t)lit || lit == 0 ||
+            serial.stage_calls[TINY3D_STAGE_CLEAR] != 1 || serial.stage_calls[TINY3D_STAGE_RASTER] != 1 ||
+            serial.overdraw <= 0.0 || tiled.pixels_written != serial.pixels_written ||
+            tiled.frame != serial.frame + 1 || idle.pixels_written != 0 ||
+            idle.stage_calls[TINY3D_STAGE_CLEAR] != 0 || strncmp(head, "{\"displayTimeUnit\"", 18) != 0) {
+            printf("✗ Frame statistics are inconsistent\n");
+            return 1;
+        }
+        printf("✓ Frame stats: %llu pixels written over %d lit, overdraw %.3f\n",
+               (unsigned long long)serial.pixels_written, lit, serial.overdraw);
+    }
+#endif
+
     // Cleanup
     free(cube_verts);
     free(cube_edges);
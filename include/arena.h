@@ -0,0 +1,55 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+/* Heap chunk backing an arena once its current region is full */
+typedef struct arena_chunk {
+    struct arena_chunk* next;
+    size_t size;  // Usable bytes following the header
+} arena_chunk_t;
+
+/* Frame arena: a bump allocator that is reset once per frame
+ * Allocations are never freed one by one. When the current region runs out
+ * a larger heap chunk is chained on, and the next reset folds all chunks
+ * into a single one, so a steady workload stops touching the heap after
+ * its first frame. An arena is not thread-safe; use one per thread. */
+typedef struct {
+    unsigned char* base;    // Current region
+    size_t size;
+    size_t used;
+    void* buffer;           // Optional caller-provided region used first
+    size_t buffer_size;
+    arena_chunk_t* chunks;  // Heap chunks, newest first
+    arena_chunk_t* spare;   // Chunks released by a rewind, reused before the heap
+} arena_t;
+
+/* Arena setup/teardown (buffer may be NULL) */
+void arena_init(arena_t* arena, void* buffer, size_t buffer_size);
+void arena_free(arena_t* arena);
+
+/* Allocation: align must be a power of two; returns NULL only if the heap is exhausted */
+void* arena_alloc(arena_t* arena, size_t size, size_t align);
+
+/* Release every allocation at once, typically at the start of a frame */
+void arena_reset(arena_t* arena);
+
+/* Saved allocation point, for scratch that is done with before the frame ends */
+typedef struct {
+    unsigned char* base;
+    size_t size;
+    size_t used;
+    arena_chunk_t* chunks;
+} arena_mark_t;
+
+/* Rewinding releases everything allocated since the mark. Chunks chained
+ * in between are kept aside and reused when the arena next runs out, so
+ * repeated mark/rewind cycles stop growing it; reset folds them in too. */
+arena_mark_t arena_mark(const arena_t* arena);
+void arena_rewind(arena_t* arena, arena_mark_t mark);
+
+/* Typed allocation helper */
+#define ARENA_ALLOC(arena, type, count) \
+    ((type*)arena_alloc((arena), sizeof(type) * (size_t)(count), _Alignof(type)))
+
+#endif // ARENA_H
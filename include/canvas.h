@@ -1,26 +1,124 @@
 #ifndef CANVAS_H
 #define CANVAS_H
 
+#include <stddef.h>
 #include <stdint.h>
 
+/* Alignment of the pixel block and of every row (one cache line) */
+#define CANVAS_ALIGNMENT 64
+
+/* Pixel storage formats; every one holds brightness from 0.0 to 1.0 */
+typedef enum {
+    CANVAS_F32 = 0,   // float
+    CANVAS_UNORM16,   // uint16_t, 65535 is 1.0
+    CANVAS_UNORM8     // uint8_t, 255 is 1.0
+} canvas_format_t;
+
+/* How drawn coverage combines with the pixel under it */
+typedef enum {
+    CANVAS_BLEND_ADD_CLAMP = 0,   // Add, clamping to 1.0 on every write (the default)
+    CANVAS_BLEND_ADD,             // Add; float values may exceed 1.0 until resolve_canvas
+    CANVAS_BLEND_MAX,             // Keep the brighter value; independent of draw order
+    CANVAS_BLEND_REPLACE,         // Covered pixels take the new value
+    CANVAS_BLEND_COUNT
+} canvas_blend_t;
+
+/* Per-format kernels, chosen when the canvas is created */
+typedef struct canvas_ops canvas_ops_t;
+
 /* Canvas structure */
 typedef struct {
     int width;
     int height;
-    float** pixels;  // 2D array of brightness values (0.0 to 1.0)
+    int stride;      // Pixels per row, padded so each row starts on a cache line
+    float* data;     // F32: single 64-byte aligned block of height * stride brightness values; NULL otherwise
+    float** pixels;  // F32: row pointers into data, kept for code that indexes pixels[y][x]
+    canvas_format_t format;
+    void* storage;   // Pixel block in any format (the same block as data for F32)
+    const canvas_ops_t* ops;
+    canvas_blend_t blend;   // Used by every drawing call; may be changed between draws
 } canvas_t;
 
 /* Canvas creation/destruction */
-canvas_t* create_canvas(int width, int height);
+canvas_t* create_canvas(int width, int height);  // CANVAS_F32
+canvas_t* create_canvas_format(int width, int height, canvas_format_t format);
 void free_canvas(canvas_t* canvas);
+void destroy_canvas(canvas_t* canvas);  // Same as free_canvas
+
+/* Bytes per pixel of a format */
+static inline size_t canvas_format_size(canvas_format_t format) {
+    return format == CANVAS_UNORM8 ? 1 : (format == CANVAS_UNORM16 ? 2 : sizeof(float));
+}
+
+/* Pixel storage access (canvas_row and canvas_pixel are for F32 canvases) */
+static inline float* canvas_row(const canvas_t* canvas, int y) {
+    return canvas->data + (size_t)y * canvas->stride;
+}
+
+static inline float* canvas_pixel(const canvas_t* canvas, int x, int y) {
+    return canvas->data + (size_t)y * canvas->stride + x;
+}
+
+static inline void* canvas_row_storage(const canvas_t* canvas, int y) {
+    return (unsigned char*)canvas->storage + (size_t)y * canvas->stride * canvas_format_size(canvas->format);
+}
+
+/* Brightness of one pixel, any format */
+float canvas_get(const canvas_t* canvas, int x, int y);
+
+/* Row y as floats: F32 rows are returned in place, others are converted
+ * into scratch (width floats) */
+const float* canvas_row_f32(const canvas_t* canvas, int y, float* scratch);
+
+/* Total number of pixels in the block, padding included */
+static inline size_t canvas_size(const canvas_t* canvas) {
+    return (size_t)canvas->height * canvas->stride;
+}
 
 /* Pixel operations */
 void set_pixel_f(canvas_t* canvas, float x, float y, float intensity);
 
-/* Drawing operations */
+/* Drawing operations
+ * A line covers the pixels within thickness / 2 of the segment, with a
+ * one-pixel antialiased fringe. Thickness must be positive: a line of zero,
+ * negative or NaN thickness draws nothing. */
 void draw_line_f(canvas_t* canvas, float x0, float y0, float x1, float y1, float thickness);
 
+/* Same pixels as draw_line_f, restricted to [min_x, max_x) x [min_y, max_y) */
+void draw_line_clipped_f(canvas_t* canvas, float x0, float y0, float x1, float y1, float thickness,
+                         int min_x, int min_y, int max_x, int max_y);
+
+/* Depth tolerance so edges that share a vertex do not hide each other */
+#define LINE_DEPTH_BIAS 1e-4f
+
+/* Line with per-endpoint attributes; zero-initialize unused fields */
+typedef struct {
+    float x0, y0, x1, y1;
+    float thickness;
+    float z0, z1;       // Depth at each end, interpolated along the line
+    float* depth;       // Optional depth buffer, one float per pixel (smaller is nearer)
+    int depth_stride;   // Floats per depth buffer row
+    int shaded;         // Nonzero: coverage is scaled by intensity i0..i1 along the line
+    float i0, i1;
+} line_desc_t;
+
+/* Draw a described line into [min_x, max_x) x [min_y, max_y).
+ * With a depth buffer, pixels whose depth is not nearer than the stored
+ * value (plus LINE_DEPTH_BIAS) are skipped, and the line's solid core
+ * writes its depth. Shading dims the line but not its depth footprint.
+ * Returns the number of pixels given nonzero coverage. */
+int draw_line_desc(canvas_t* canvas, const line_desc_t* line,
+                   int min_x, int min_y, int max_x, int max_y);
+
 /* Helper functions */
 void clear_canvas(canvas_t* canvas, float brightness);
+void fill_canvas_rect(canvas_t* canvas, int x, int y, int w, int h, float brightness);
+
+/* Scale every pixel and clamp the result to [0,1]; this is where
+ * CANVAS_BLEND_ADD saturates */
+void resolve_canvas(canvas_t* canvas, float scale);
+
+/* Quantize to 8-bit rows of out_stride bytes (0 maps to 0, 1 maps to 255) */
+void canvas_to_u8(const canvas_t* canvas, uint8_t* out, int out_stride);
 
-#endif // CANVAS_H
\ No newline at end of file
+#endif // CANVAS_H
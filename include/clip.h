@@ -0,0 +1,34 @@
+#ifndef CLIP_H
+#define CLIP_H
+
+#include "math3d.h"
+
+/* Homogeneous clip planes (OpenGL convention: -w <= x, y, z <= w) */
+#define CLIP_LEFT    0x01
+#define CLIP_RIGHT   0x02
+#define CLIP_BOTTOM  0x04
+#define CLIP_TOP     0x08
+#define CLIP_NEAR    0x10
+#define CLIP_FAR     0x20
+#define CLIP_DEPTH   (CLIP_NEAR | CLIP_FAR)
+#define CLIP_FRUSTUM (CLIP_LEFT | CLIP_RIGHT | CLIP_BOTTOM | CLIP_TOP | CLIP_DEPTH)
+
+/* Segment clipping
+ * Each function trims the segment in place and returns 0 when nothing is
+ * left. Endpoints only move along the segment, so attributes can be
+ * interpolated with the parameters reported through t0/t1 (may be NULL). */
+
+/* Clip against the selected frustum planes before the perspective divide */
+int clip_segment_homogeneous(vec4_t* a, vec4_t* b, int planes, float* t0, float* t1);
+
+/* Clip against the rectangle [min_x, max_x] x [min_y, max_y] (Liang-Barsky) */
+int clip_segment_rect(float* x0, float* y0, float* x1, float* y1,
+                      float min_x, float min_y, float max_x, float max_y,
+                      float* t0, float* t1);
+
+/* Clip against the axis-aligned ellipse centered at (cx, cy) with radii rx, ry */
+int clip_segment_ellipse(float* x0, float* y0, float* x1, float* y1,
+                         float cx, float cy, float rx, float ry,
+                         float* t0, float* t1);
+
+#endif // CLIP_H
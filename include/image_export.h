@@ -0,0 +1,23 @@
+#ifndef IMAGE_EXPORT_H
+#define IMAGE_EXPORT_H
+
+#include "canvas.h"
+
+/* Image export
+ * Rows are quantized with the SIMD kernels one at a time and streamed
+ * through a small buffer to the file descriptor, so no full-size copy of
+ * the image is ever made. bit_depth is 8 or 16; 16-bit samples are written
+ * big-endian as both formats require. PNG output is a valid zlib stream of
+ * stored (uncompressed) blocks: fast to write, larger on disk.
+ * All functions return 0 on success and -1 on error. */
+int canvas_write_pgm(const canvas_t* canvas, int fd, int bit_depth);  // Binary P5
+int canvas_write_ppm(const canvas_t* canvas, int fd, int bit_depth);  // Binary P6, gray in all channels
+int canvas_write_png(const canvas_t* canvas, int fd, int bit_depth);  // Grayscale PNG
+
+/* Write to a path, picking the format from its extension (.pgm, .ppm, .png) */
+int save_canvas(const canvas_t* canvas, const char* path, int bit_depth);
+
+/* 8-bit binary PGM at a path */
+int save_canvas_to_pgm(const canvas_t* canvas, const char* path);
+
+#endif // IMAGE_EXPORT_H
@@ -21,4 +21,36 @@ float compute_lighting(vec3_t normal, light_t* lights, int light_count);
 void add_light(light_t* lights, int* light_count, vec3_t direction, float intensity);
 void remove_light(light_t* lights, int* light_count, int index);
 
+/* Lighting of an edge from v0 to v1, using the screen-space perpendicular
+ * (dy, -dx, 0) of its direction as the normal */
+float calculate_edge_lighting(vec3_t v0, vec3_t v1, light_t* lights, int light_count);
+
+/* Light set
+ * The same lights as light_t, stored as a structure of arrays and
+ * normalized once when added, so shading a batch of normals is a single
+ * vectorized pass. Every ISA produces bit-identical results. */
+typedef struct {
+    float x[MAX_LIGHTS];           // Unit directions
+    float y[MAX_LIGHTS];
+    float z[MAX_LIGHTS];
+    float intensity[MAX_LIGHTS];
+    int count;
+} light_set_t;
+
+void light_set_init(light_set_t* set);
+int light_set_add(light_set_t* set, vec3_t direction, float intensity);  // Index, or -1 when full or zero
+void light_set_remove(light_set_t* set, int index);
+
+/* Intensity in [0,1] for count normals given as separate x/y/z arrays.
+ * Normals need not be unit length; zero normals get 0. */
+void light_set_shade_soa(const light_set_t* set, const float* nx, const float* ny, const float* nz,
+                         int count, float* out);
+
+/* Single normal, same result as one lane of light_set_shade_soa */
+float light_set_shade(const light_set_t* set, vec3_t normal);
+
+/* calculate_edge_lighting for every edge (pairs of vertex indices) */
+void light_set_shade_edges(const light_set_t* set, const vec3_t* vertices, const int* edges,
+                           int edge_count, float* out);
+
 #endif // LIGHTING_H
\ No newline at end of file
@@ -4,12 +4,23 @@
 #include <stdint.h>
 #include <math.h>
 
-/* 3D Vector structure with both Cartesian and Spherical coordinates */
+/* 3D Vector structure (Cartesian only, 12 bytes) */
 typedef struct {
-    float x, y, z;      // Cartesian coordinates
-    float r, theta, phi; // Spherical coordinates
+    float x, y, z;
 } vec3_t;
 
+/* Spherical coordinates, computed on request with vec3_to_spherical */
+typedef struct {
+    float r;      // Radius
+    float theta;  // Polar angle from +Z
+    float phi;    // Azimuth in the XY plane from +X
+} spherical_t;
+
+/* Homogeneous clip-space point */
+typedef struct {
+    float x, y, z, w;
+} vec4_t;
+
 /* 4x4 Matrix structure (column-major) */
 typedef struct {
     float m[4][4];  // [column][row] format
@@ -17,14 +28,15 @@ typedef struct {
 
 /* Vector operations */
 vec3_t vec3_from_spherical(float r, float theta, float phi);
-void vec3_normalize_fast(vec3_t* v);
+spherical_t vec3_to_spherical(vec3_t v);
+void vec3_normalize_fast(vec3_t* v);  // No trig: one inverse square root
 vec3_t vec3_slerp(vec3_t a, vec3_t b, float t);
 
 /* Matrix operations */
 mat4_t mat4_identity(void);
 mat4_t mat4_translate(float tx, float ty, float tz);
 mat4_t mat4_scale(float sx, float sy, float sz);
-mat4_t mat4_rotate_xyz(float rx, float ry, float rz);
+mat4_t mat4_rotate_xyz(float rx, float ry, float rz);  // Rotates about Z, then Y, then X
 mat4_t mat4_mul(mat4_t a, mat4_t b);
 mat4_t mat4_frustum_asymmetric(float left, float right, float bottom, float top, float near, float far);
 
@@ -37,6 +49,7 @@ vec3_t vec3_scale(vec3_t a, float s);
 
 /* Matrix-vector operations */
 vec3_t mat4_mul_vec3(mat4_t m, vec3_t v);
+vec4_t mat4_mul_point(mat4_t m, vec3_t v);  // No perspective divide
 
 /* Model creation functions */
 void create_cube(vec3_t** vertices, int** edges, int* vertex_count, int* edge_count);
@@ -0,0 +1,49 @@
+#ifndef MESH_H
+#define MESH_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "math3d.h"
+
+/* Wireframe mesh: the same arrays render_wireframe takes */
+typedef struct {
+    vec3_t* vertices;
+    int vertex_count;
+    int* edges;           // Pairs of vertex indices
+    int edge_count;
+    void* mapping;        // Set when the arrays point into a read-only mapped file
+    size_t mapping_size;
+} mesh_t;
+
+/* Binary mesh file (.t3dm)
+ * A fixed header followed by the vertex array (three little-endian floats
+ * per vertex, the layout of vec3_t) and the edge array (pairs of int32),
+ * each starting on a 64-byte boundary. A mapped file is used in place. */
+#define MESH_BINARY_MAGIC "T3DM"
+#define MESH_BINARY_VERSION 1
+
+typedef struct {
+    char magic[4];
+    uint32_t version;
+    uint32_t byte_order;    // 0x01020304 as written by the producing machine
+    uint32_t vertex_count;
+    uint32_t edge_count;
+    uint32_t reserved;
+    uint64_t vertex_offset; // Byte offsets from the start of the file
+    uint64_t edge_offset;
+} mesh_binary_header_t;
+
+/* Streaming Wavefront OBJ import
+ * The file is read one line at a time. Polygon (f) and polyline (l)
+ * elements become edges, and every edge is stored once no matter how many
+ * faces share it. Returns 0 on success, -1 on error. */
+int mesh_load_obj(const char* path, mesh_t* mesh);
+
+/* Binary mesh export and zero-copy import (0 on success, -1 on error) */
+int mesh_save_binary(const char* path, const mesh_t* mesh);
+int mesh_map_binary(const char* path, mesh_t* mesh);
+
+/* Release a loaded or mapped mesh */
+void mesh_free(mesh_t* mesh);
+
+#endif // MESH_H
@@ -0,0 +1,57 @@
+#ifndef PRESENTER_H
+#define PRESENTER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "canvas.h"
+
+/* Glyph style of a terminal cell */
+typedef enum {
+    PRESENTER_RAMP,       // One brightness per cell, drawn from an ASCII ramp
+    PRESENTER_HALF_BLOCK  // Two pixels per cell: U+2580 with 256-color gray fg/bg
+} presenter_mode_t;
+
+/* Presenter settings; zero fields take the defaults noted */
+typedef struct {
+    int cols;             // Cells across (default 40)
+    int rows;             // Cells down (default 40)
+    presenter_mode_t mode;
+    const char* ramp;     // Darkest to brightest (default " .+#")
+    int cell_width;       // Ramp glyphs per cell, 2 keeps cells square (default 2)
+    int origin_row;       // 1-based terminal position of the top-left cell (default 1, 1)
+    int origin_col;
+    int fd;               // Output descriptor (default 0 means stdout)
+} presenter_config_t;
+
+/* Diff-based terminal presenter
+ * The canvas is reduced to cells, taking the brightest pixel of each cell
+ * so thin lines survive downsampling. Only cells that differ from the last
+ * presented frame are sent, as cursor moves plus glyphs, and everything a
+ * frame produces leaves in one write(). */
+typedef struct {
+    presenter_config_t config;
+    uint16_t* cells;      // Codes of the frame being built
+    uint16_t* shown;      // Codes currently on the terminal
+    int shown_valid;      // 0 until the first full frame is out
+    char* out;            // Pending output
+    size_t out_len;
+    size_t out_cap;
+} presenter_t;
+
+/* Setup/teardown; free resets the colors and shows the cursor again */
+int presenter_init(presenter_t* p, const presenter_config_t* config);
+void presenter_free(presenter_t* p);
+
+/* Clear the terminal and repaint every cell on the next present */
+void presenter_clear_screen(presenter_t* p);
+
+/* Queue a line of text at a 1-based terminal row, replacing what was there */
+void presenter_text(presenter_t* p, int row, const char* text);
+
+/* Send the changed cells and any queued text; returns bytes written or -1 */
+long presenter_present(presenter_t* p, const canvas_t* canvas);
+
+/* Send queued text alone, for frames that are not a canvas */
+long presenter_flush(presenter_t* p);
+
+#endif // PRESENTER_H
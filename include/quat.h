@@ -0,0 +1,45 @@
+#ifndef QUAT_H
+#define QUAT_H
+
+#include "math3d.h"
+
+/* Unit quaternion orientation; w is the scalar part */
+typedef struct {
+    float x, y, z, w;
+} quat_t;
+
+/* Construction */
+quat_t quat_identity(void);
+quat_t quat_from_axis_angle(vec3_t axis, float angle);   // Axis need not be unit length
+quat_t quat_from_euler_xyz(float rx, float ry, float rz); // Same rotation as mat4_rotate_xyz
+
+/* Composition in mat4_mul order: a is applied first, then b */
+quat_t quat_mul(quat_t a, quat_t b);
+quat_t quat_conjugate(quat_t q);   // Inverse of a unit quaternion
+quat_t quat_normalize(quat_t q);
+vec3_t quat_rotate_vec3(quat_t q, vec3_t v);
+mat4_t quat_to_mat4(quat_t q);
+
+/* Interpolation along the shorter arc. nlerp is a normalized linear blend:
+ * cheaper, with uneven angular speed. slerp keeps constant angular speed
+ * and falls back to nlerp when the two are nearly equal. */
+quat_t quat_nlerp(quat_t a, quat_t b, float t);
+quat_t quat_slerp(quat_t a, quat_t b, float t);
+
+/* Orientations as a structure of arrays, for batches */
+typedef struct {
+    float* x;
+    float* y;
+    float* z;
+    float* w;
+} quat_soa_t;
+
+/* out[i] = quat_slerp(a[i], b[i], t[i]) with the same results; the trig
+ * runs through the batched trig kernels. out may alias a or b. */
+void quat_slerp_n(const quat_soa_t* a, const quat_soa_t* b, const float* t, const quat_soa_t* out, int count);
+
+/* out[i] = quat_to_mat4(q[i]) followed by a translation to positions[i] (may be NULL),
+ * ready for render_wireframe_instanced */
+void quat_to_mat4_n(const quat_soa_t* q, const vec3_t* positions, mat4_t* out, int count);
+
+#endif // QUAT_H
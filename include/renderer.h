@@ -1,8 +1,65 @@
 #ifndef RENDERER_H
 #define RENDERER_H
 
-#include "tiny3d.h"
+#include "canvas.h"
 #include "math3d.h"
+#include "lighting.h"
+#include "threadpool.h"
+#include "arena.h"
+
+/* Screen tile edge length used by the parallel renderer */
+#define RENDER_TILE_SIZE 64
+
+/* Stack scratch used when no arena is passed; larger models spill to the heap */
+#define RENDER_LOCAL_SCRATCH 8192
+
+/* Screen edges gathered per rasterization batch by the instanced renderer */
+#define RENDER_INSTANCE_BATCH_EDGES 65536
+
+/* Depth buffer (optional for bonus)
+ * Depth is NDC z, so 1.0 is the far plane. A coarse hierarchical-Z level
+ * keeps the farthest depth of every Z_BUFFER_HIZ_TILE square, letting the
+ * renderer reject whole segments that lie behind everything drawn there. */
+#define Z_BUFFER_HIZ_TILE 16  // Must divide RENDER_TILE_SIZE
+
+typedef struct {
+    float* buffer;
+    int width;
+    int height;
+    float* hiz;               // Farthest depth per tile, never nearer than the truth
+    unsigned char* hiz_dirty; // Tiles whose hiz value may be too far and can be tightened
+    int hiz_cols;
+    int hiz_rows;
+} z_buffer_t;
+
+/* On allocation failure, or for an empty size, buffer, hiz and hiz_dirty
+ * are all NULL and renderers ignore the depth buffer */
+void init_z_buffer(z_buffer_t* zbuf, int width, int height);
+void free_z_buffer(z_buffer_t* zbuf);
+void clear_z_buffer(z_buffer_t* zbuf);
+int z_buffer_test(z_buffer_t* zbuf, int x, int y, float depth);
+
+/* Hierarchical-Z queries over the pixel rectangle [x0, x1) x [y0, y1) */
+int z_buffer_region_occluded(z_buffer_t* zbuf, float min_depth, int x0, int y0, int x1, int y1);
+void z_buffer_mark_dirty(z_buffer_t* zbuf, int x0, int y0, int x1, int y1);
+
+/* Lit wireframe modes; intensities are computed in world space while the
+ * vertices are transformed, and scale each line's coverage */
+typedef enum {
+    RENDER_LIGHT_EDGE = 0,  // One intensity per edge, from the perpendicular calculate_edge_lighting uses
+    RENDER_LIGHT_VERTEX     // Per vertex, normal pointing away from the vertex centroid; interpolated along edges
+} render_lighting_t;
+
+/* Optional render state; zero-initialize and set what is needed */
+typedef struct {
+    arena_t* arena;             // Per-frame scratch (NULL: stack scratch freed on return)
+    thread_pool_t* pool;        // Tile-parallel rasterization (NULL: single thread)
+    z_buffer_t* zbuf;           // Depth-tested hidden-line mode, sized like the canvas (NULL: off)
+    const light_set_t* lights;  // Lit mode (NULL: every line at full intensity)
+    render_lighting_t lighting;
+    const mat4_t* model;        // Object to world for lighting, affine (NULL: identity);
+                                // the instanced and scene renderers use each instance's own
+} render_options_t;
 
 /* Vertex projection */
 void project_vertex(mat4_t mvp, vec3_t vertex, float* screen_x, float* screen_y);
@@ -21,15 +78,49 @@ void render_wireframe(
     float thickness
 );
 
-/* Depth buffer (optional for bonus) */
-typedef struct {
-    float* buffer;
-    int width;
-    int height;
-} z_buffer_t;
+/* Wireframe rendering with options
+ * Temporaries come from options->arena and are not released on return;
+ * the owner resets the arena once per frame. */
+void render_wireframe_ex(
+    canvas_t* canvas,
+    mat4_t mvp,
+    vec3_t* vertices,
+    int vertex_count,
+    int* edges,
+    int edge_count,
+    float thickness,
+    const render_options_t* options
+);
 
-void init_z_buffer(z_buffer_t* zbuf, int width, int height);
-void free_z_buffer(z_buffer_t* zbuf);
-int z_buffer_test(z_buffer_t* zbuf, int x, int y, float depth);
+/* Instanced wireframe rendering
+ * Draws the model once per entry of models (object to world), each
+ * composed with the shared view_proj. The image matches one
+ * render_wireframe_ex call per instance, in order. */
+void render_wireframe_instanced(
+    canvas_t* canvas,
+    mat4_t view_proj,
+    vec3_t* vertices,
+    int vertex_count,
+    int* edges,
+    int edge_count,
+    const mat4_t* models,
+    int instance_count,
+    float thickness,
+    const render_options_t* options
+);
+
+/* Parallel wireframe rendering
+ * Edges are binned into RENDER_TILE_SIZE tiles and the tiles are rasterized
+ * on the pool's workers. Output is bit-identical to render_wireframe. */
+void render_wireframe_parallel(
+    thread_pool_t* pool,
+    canvas_t* canvas,
+    mat4_t mvp,
+    vec3_t* vertices,
+    int vertex_count,
+    int* edges,
+    int edge_count,
+    float thickness
+);
 
-#endif // RENDERER_H
\ No newline at end of file
+#endif // RENDERER_H
@@ -0,0 +1,77 @@
+#ifndef SCENE_H
+#define SCENE_H
+
+#include "canvas.h"
+#include "math3d.h"
+#include "renderer.h"
+
+/* Axis-aligned bounding box */
+typedef struct {
+    vec3_t min;
+    vec3_t max;
+} aabb_t;
+
+/* Scene model: a mesh the scene references (not owns) plus its placement */
+typedef struct {
+    vec3_t* vertices;
+    int vertex_count;
+    int* edges;
+    int edge_count;
+    mat4_t model;          // Object to world, affine
+    aabb_t local_box;      // Object-space bounds, computed once on add
+    vec3_t local_center;   // Bounding sphere, also object space
+    float local_radius;
+    aabb_t world_box;      // Refreshed whenever the transform changes
+} scene_model_t;
+
+/* BVH node; children always follow their parent in the node array */
+typedef struct {
+    aabb_t box;
+    int left;    // Child node indices, -1 for a leaf
+    int right;
+    int first;   // Leaf: range [first, first + count) of scene->order
+    int count;
+} bvh_node_t;
+
+#define SCENE_BVH_LEAF_SIZE 4
+
+/* Scene of wireframe models with a bounding-volume hierarchy
+ * The BVH is rebuilt after models are added and refitted after transforms
+ * change, both lazily on the next cull. Culling tests whole subtrees
+ * against the frustum and the circular viewport, so the cost of a frame
+ * follows the number of visible models rather than the scene size. */
+typedef struct {
+    scene_model_t* models;
+    int model_count;
+    int model_capacity;
+    bvh_node_t* nodes;
+    int node_count;
+    int* order;        // Model ids in leaf order
+    int* visible;      // Cull output, one slot per model
+    int needs_build;   // Models added since the last build
+    int needs_refit;   // Transforms changed since the last build
+} scene_t;
+
+/* Scene setup/teardown */
+void scene_init(scene_t* scene);
+void scene_free(scene_t* scene);
+
+/* Add a model; returns its id, or -1 on error. The arrays must outlive the scene. */
+int scene_add_model(scene_t* scene, vec3_t* vertices, int vertex_count,
+                    int* edges, int edge_count, mat4_t model);
+void scene_set_transform(scene_t* scene, int id, mat4_t model);
+
+/* Bring the BVH up to date now instead of on the next cull (0 on success, -1 on error) */
+int scene_build(scene_t* scene);
+
+/* Write the ids of the models that may cover a pixel of a width x height
+ * canvas to visible (model_count slots), in the order they were added.
+ * Lines of the given thickness are accounted for. Returns the count. */
+int scene_cull(scene_t* scene, mat4_t view_proj, int width, int height, float thickness, int* visible);
+
+/* Cull, then draw the surviving models with render_wireframe_ex in the
+ * order they were added. Returns the number of models drawn. */
+int scene_render(scene_t* scene, canvas_t* canvas, mat4_t view_proj, float thickness,
+                 const render_options_t* options);
+
+#endif // SCENE_H
@@ -0,0 +1,37 @@
+#ifndef SIMD_H
+#define SIMD_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* x86 vector kernels are built with per-function target attributes, so the
+ * library itself needs no -m flags. Define TINY3D_NO_SIMD to build scalar only. */
+#if !defined(TINY3D_NO_SIMD) && (defined(__GNUC__) || defined(__clang__)) && \
+    (defined(__x86_64__) || defined(__i386__))
+#define TINY3D_X86_SIMD 1
+#endif
+
+/* Instruction sets, ordered from narrowest to widest */
+typedef enum {
+    TINY3D_ISA_SCALAR = 0,
+    TINY3D_ISA_SSE2,
+    TINY3D_ISA_AVX2,
+    TINY3D_ISA_AVX512
+} tiny3d_isa_t;
+
+/* CPU dispatch
+ * The widest supported ISA is picked once at startup. Setting the
+ * TINY3D_ISA environment variable (scalar, sse2, avx2, avx512) caps it,
+ * and simd_force_isa does the same from code. */
+tiny3d_isa_t simd_detect_isa(void);
+tiny3d_isa_t simd_active_isa(void);
+tiny3d_isa_t simd_force_isa(tiny3d_isa_t isa);  // Returns the ISA actually selected
+const char* simd_isa_name(tiny3d_isa_t isa);
+
+/* Buffer kernels */
+void simd_fill_f32(float* dst, size_t count, float value);
+void simd_scale_clamp_f32(float* dst, const float* src, size_t count, float scale);  // dst = clamp(src * scale, 0, 1)
+void simd_quantize_u8(uint8_t* dst, const float* src, size_t count);                 // dst = round(clamp(src, 0, 1) * 255)
+void simd_quantize_u16(uint16_t* dst, const float* src, size_t count);               // dst = round(clamp(src, 0, 1) * 65535)
+
+#endif // SIMD_H
@@ -0,0 +1,92 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <stdint.h>
+
+/* Pipeline instrumentation
+ * Per-stage wall time from the monotonic clock plus geometry and pixel
+ * counters, gathered between tiny3d_stats_begin_frame and
+ * tiny3d_stats_end_frame. Stage spans are also kept as trace events, which
+ * tiny3d_stats_save_trace writes as Chrome trace JSON (chrome://tracing,
+ * Perfetto). Counters are safe to update from pool workers. Outside a
+ * frame the hooks return after one relaxed load, without reading the clock
+ * or touching shared counters, so an application that never begins a frame
+ * pays next to nothing. Define TINY3D_NO_STATS to compile every hook out;
+ * the API stays and reports zeros. */
+#ifndef TINY3D_NO_STATS
+#define TINY3D_STATS 1
+#endif
+
+typedef enum {
+    TINY3D_STAGE_TRANSFORM = 0,  // Vertices to screen space
+    TINY3D_STAGE_CLIP,           // Depth, canvas and viewport clipping of edges
+    TINY3D_STAGE_RASTER,         // Binning and drawing the visible edges
+    TINY3D_STAGE_LIGHTING,       // Light set shading of vertices or edges
+    TINY3D_STAGE_CLEAR,          // clear_canvas
+    TINY3D_STAGE_PRESENT,        // presenter_present, video_submit_frame
+    TINY3D_STAGE_COUNT
+} tiny3d_stage_t;
+
+typedef struct {
+    uint64_t frame;                              // Frames ended so far, this one included
+    uint64_t frame_ns;                           // begin_frame to end_frame
+    uint64_t stage_ns[TINY3D_STAGE_COUNT];       // Summed over every call in the frame
+    uint64_t stage_calls[TINY3D_STAGE_COUNT];
+    uint64_t vertices_transformed;
+    uint64_t edges_submitted;
+    uint64_t edges_culled;     // Invalid, or entirely outside the depth range, canvas or viewport
+    uint64_t edges_clipped;    // Drawn, but shortened by a clip
+    uint64_t edges_drawn;
+    uint64_t pixels_written;   // Nonzero coverage that passed the depth test
+    uint64_t canvas_pixels;    // Area of the largest canvas drawn to
+    double overdraw;           // pixels_written / canvas_pixels
+    uint64_t trace_dropped;    // Events beyond TINY3D_TRACE_EVENTS
+} tiny3d_frame_stats_t;
+
+/* Trace events kept per frame */
+#ifndef TINY3D_TRACE_EVENTS
+#define TINY3D_TRACE_EVENTS 4096
+#endif
+
+/* Frame boundaries: begin resets the counters, end freezes them; ending
+ * without a frame begun keeps the last statistics */
+void tiny3d_stats_begin_frame(void);
+void tiny3d_stats_end_frame(void);
+
+/* Statistics of the last ended frame */
+tiny3d_frame_stats_t tiny3d_get_frame_stats(void);
+
+const char* tiny3d_stage_name(tiny3d_stage_t stage);
+
+/* Chrome trace JSON of the last ended frame. Returns 0 on success and -1
+ * on error, or when statistics are compiled out. */
+int tiny3d_stats_save_trace(const char* path);
+
+/* Hooks for the pipeline. stats_stage_begin returns a timestamp to hand to
+ * stats_stage_end, which adds the span to the stage and the trace; lane 0
+ * is the calling thread and pool worker w uses lane w + 1. */
+typedef enum {
+    TINY3D_COUNT_VERTICES = 0,
+    TINY3D_COUNT_EDGES_SUBMITTED,
+    TINY3D_COUNT_EDGES_CULLED,
+    TINY3D_COUNT_EDGES_CLIPPED,
+    TINY3D_COUNT_EDGES_DRAWN,
+    TINY3D_COUNT_PIXELS,
+    TINY3D_COUNT_TOTAL
+} tiny3d_counter_t;
+
+#ifdef TINY3D_STATS
+uint64_t stats_stage_begin(void);
+void stats_stage_end(tiny3d_stage_t stage, uint64_t start, int lane);
+void stats_count(tiny3d_counter_t counter, uint64_t n);
+void stats_canvas(int width, int height);
+#else
+static inline uint64_t stats_stage_begin(void) { return 0; }
+static inline void stats_stage_end(tiny3d_stage_t stage, uint64_t start, int lane) {
+    (void)stage; (void)start; (void)lane;
+}
+static inline void stats_count(tiny3d_counter_t counter, uint64_t n) { (void)counter; (void)n; }
+static inline void stats_canvas(int width, int height) { (void)width; (void)height; }
+#endif
+
+#endif // STATS_H
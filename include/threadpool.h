@@ -0,0 +1,23 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+/* Persistent worker pool
+ * Workers are started once and sleep between jobs, so a pool can be kept
+ * for the lifetime of the application and reused every frame. Builds
+ * without pthreads (or with TINY3D_NO_THREADS) run every job inline. */
+typedef struct thread_pool thread_pool_t;
+
+/* Task callback: task is in [0, task_count), worker in [0, thread_count) */
+typedef void (*thread_task_fn)(void* ctx, int task, int worker);
+
+/* Pool creation/destruction (thread_count <= 0 uses every online CPU) */
+thread_pool_t* thread_pool_create(int thread_count);
+void thread_pool_destroy(thread_pool_t* pool);
+
+/* Number of threads that execute tasks, the calling thread included */
+int thread_pool_size(const thread_pool_t* pool);
+
+/* Run fn for every task and return once all of them have finished */
+void thread_pool_run(thread_pool_t* pool, int task_count, thread_task_fn fn, void* ctx);
+
+#endif // THREADPOOL_H
@@ -5,5 +5,18 @@
 #include "math3d.h"
 #include "renderer.h"
 #include "lighting.h"
+#include "simd.h"
+#include "threadpool.h"
+#include "transform.h"
+#include "arena.h"
+#include "clip.h"
+#include "mesh.h"
+#include "scene.h"
+#include "presenter.h"
+#include "image_export.h"
+#include "video.h"
+#include "trig.h"
+#include "quat.h"
+#include "stats.h"
 
 #endif // TINY3D_H
\ No newline at end of file
@@ -0,0 +1,35 @@
+#ifndef TRANSFORM_H
+#define TRANSFORM_H
+
+#include "math3d.h"
+
+/* Batched vertex transform
+ * Positions come in as a structure of arrays and are pushed through the
+ * MVP, the perspective divide and the viewport mapping in one pass, 4 to
+ * 16 vertices per iteration depending on the dispatched ISA. Every ISA
+ * produces bit-identical results.
+ *
+ *   out_x     = (ndc.x + 1) * 0.5 * viewport_w
+ *   out_y     = (1 - ndc.y) * 0.5 * viewport_h
+ *   out_depth = ndc.z (may be NULL)
+ *   out_w     = clip-space w before the divide (may be NULL)
+ *
+ * As in mat4_mul_vec3, a clip w of 0 skips the divide. */
+void transform_points_soa(
+    const mat4_t* mvp,
+    const float* x,
+    const float* y,
+    const float* z,
+    int count,
+    float viewport_w,
+    float viewport_h,
+    float* out_x,
+    float* out_y,
+    float* out_depth,
+    float* out_w
+);
+
+/* Split an array of vec3_t into separate x/y/z arrays */
+void vec3_to_soa(const vec3_t* v, int count, float* x, float* y, float* z);
+
+#endif // TRANSFORM_H
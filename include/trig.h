@@ -0,0 +1,38 @@
+#ifndef TRIG_H
+#define TRIG_H
+
+/* Fast trigonometry
+ * Polynomial sin/cos, acos and atan2 in two accuracies, plus the libm
+ * calls for reference. Maximum absolute error against double-precision
+ * libm, for finite inputs; sincos reduces |x| < 8192 itself and hands
+ * larger, infinite and NaN arguments to sinf/cosf:
+ *
+ *                   sincos    acos      atan2
+ *   TRIG_ACCURATE   2e-7      5e-7      5e-7
+ *   TRIG_FAST       2e-5      5e-5      2e-5
+ *
+ * Batched calls run 4 to 16 values per iteration depending on the
+ * dispatched ISA, bit-identical to the single-value calls. atan2(0, 0) is
+ * 0, with the sign of y giving +-pi for x < 0 as in libm. */
+typedef enum {
+    TRIG_ACCURATE = 0,  // Near full float precision
+    TRIG_FAST,          // Shorter polynomials, plenty for screen-space geometry
+    TRIG_LIBM           // sinf/cosf/acosf/atan2f
+} trig_accuracy_t;
+
+/* Accuracy used inside the library (math3d); override with e.g.
+ * -DTINY3D_TRIG_DEFAULT=TRIG_LIBM to reproduce libm results exactly */
+#ifndef TINY3D_TRIG_DEFAULT
+#define TINY3D_TRIG_DEFAULT TRIG_ACCURATE
+#endif
+
+void trig_sincos(float x, float* s, float* c, trig_accuracy_t accuracy);
+float trig_acos(float x, trig_accuracy_t accuracy);
+float trig_atan2(float y, float x, trig_accuracy_t accuracy);
+
+/* Batched forms; s or c may be NULL */
+void trig_sincos_n(const float* x, float* s, float* c, int count, trig_accuracy_t accuracy);
+void trig_acos_n(const float* x, float* out, int count, trig_accuracy_t accuracy);
+void trig_atan2_n(const float* y, const float* x, float* out, int count, trig_accuracy_t accuracy);
+
+#endif // TRIG_H
@@ -0,0 +1,29 @@
+#ifndef VIDEO_H
+#define VIDEO_H
+
+#include "canvas.h"
+
+/* Number of frame buffers cycled between the caller and the writer thread */
+#define VIDEO_FRAME_BUFFERS 2
+
+/* Y4M frame-sequence writer
+ * Frames are streamed as YUV4MPEG2 (4:2:0, full range, neutral chroma) to
+ * a file descriptor such as stdout or a named pipe, for an external
+ * encoder to consume. Submitting a frame quantizes the canvas into a free
+ * buffer and returns; a writer thread sends it while the caller renders
+ * the next one. Builds without pthreads (or with TINY3D_NO_THREADS) write
+ * each frame before video_submit_frame returns. */
+typedef struct video_writer video_writer_t;
+
+/* Writes the stream header; returns NULL on error */
+video_writer_t* video_open_y4m(int fd, int width, int height, int fps);
+
+/* Queue a frame; the canvas must be width x height and may be reused at once.
+ * Returns 0, or -1 once any write has failed. */
+int video_submit_frame(video_writer_t* writer, const canvas_t* canvas);
+
+/* Wait for queued frames, stop the thread and free the writer (the fd stays open).
+ * Returns 0 if every frame was written, -1 otherwise. */
+int video_close(video_writer_t* writer);
+
+#endif // VIDEO_H
@@ -0,0 +1,156 @@
+#include "arena.h"
+#include <stdint.h>
+#include <stdlib.h>
+
+/* Smallest heap chunk, so tiny arenas do not chain dozens of chunks */
+#define ARENA_MIN_CHUNK (64 * 1024)
+
+/* Chunks are allocated on a cache line and the header is padded to one,
+ * so chunk payloads start on a cache line too */
+#define ARENA_CHUNK_ALIGNMENT 64
+#define ARENA_CHUNK_HEADER ((sizeof(arena_chunk_t) + ARENA_CHUNK_ALIGNMENT - 1) & \
+                            ~(size_t)(ARENA_CHUNK_ALIGNMENT - 1))
+
+static unsigned char* chunk_data(arena_chunk_t* chunk) {
+    return (unsigned char*)chunk + ARENA_CHUNK_HEADER;
+}
+
+static arena_chunk_t* chunk_create(size_t size) {
+    void* ptr = NULL;
+#ifdef _WIN32
+    ptr = _aligned_malloc(ARENA_CHUNK_HEADER + size, ARENA_CHUNK_ALIGNMENT);
+#else
+    if (posix_memalign(&ptr, ARENA_CHUNK_ALIGNMENT, ARENA_CHUNK_HEADER + size) != 0) ptr = NULL;
+#endif
+    arena_chunk_t* chunk = (arena_chunk_t*)ptr;
+    if (!chunk) return NULL;
+    chunk->next = NULL;
+    chunk->size = size;
+    return chunk;
+}
+
+static void chunk_destroy(arena_chunk_t* chunk) {
+#ifdef _WIN32
+    _aligned_free(chunk);
+#else
+    free(chunk);
+#endif
+}
+
+void arena_init(arena_t* arena, void* buffer, size_t buffer_size) {
+    arena->buffer = buffer;
+    arena->buffer_size = buffer ? buffer_size : 0;
+    arena->base = (unsigned char*)arena->buffer;
+    arena->size = arena->buffer_size;
+    arena->used = 0;
+    arena->chunks = NULL;
+    arena->spare = NULL;
+}
+
+static void chunk_list_destroy(arena_chunk_t* chunk) {
+    while (chunk) {
+        arena_chunk_t* next = chunk->next;
+        chunk_destroy(chunk);
+        chunk = next;
+    }
+}
+
+void arena_free(arena_t* arena) {
+    if (!arena) return;
+
+    chunk_list_destroy(arena->chunks);
+    chunk_list_destroy(arena->spare);
+    arena_init(arena, arena->buffer, arena->buffer_size);
+}
+
+void* arena_alloc(arena_t* arena, size_t size, size_t align) {
+    if (align == 0) align = 1;
+
+    uintptr_t start = (uintptr_t)(arena->base + arena->used);
+    size_t pad = (size_t)((align - (start & (align - 1))) & (align - 1));
+    if (arena->base && arena->used + pad + size <= arena->size) {
+        arena->used += pad + size;
+        return (void*)(start + pad);
+    }
+
+    // Chain a spare chunk big enough for the request, if a rewind left one
+    size_t want = size + align;
+    arena_chunk_t* chunk = NULL;
+    for (arena_chunk_t** link = &arena->spare; *link; link = &(*link)->next) {
+        if ((*link)->size >= want) {
+            chunk = *link;
+            *link = chunk->next;
+            break;
+        }
+    }
+
+    // Otherwise one at least twice as big as the region that just ran out
+    if (!chunk) {
+        size_t grow = arena->size * 2;
+        if (grow < ARENA_MIN_CHUNK) grow = ARENA_MIN_CHUNK;
+        chunk = chunk_create(want > grow ? want : grow);
+        if (!chunk) return NULL;
+    }
+    chunk->next = arena->chunks;
+    arena->chunks = chunk;
+    arena->base = chunk_data(chunk);
+    arena->size = chunk->size;
+    arena->used = 0;
+
+    return arena_alloc(arena, size, align);
+}
+
+arena_mark_t arena_mark(const arena_t* arena) {
+    arena_mark_t mark;
+    mark.base = arena->base;
+    mark.size = arena->size;
+    mark.used = arena->used;
+    mark.chunks = arena->chunks;
+    return mark;
+}
+
+void arena_rewind(arena_t* arena, arena_mark_t mark) {
+    // Chunks chained since the mark move to the spare list
+    while (arena->chunks && arena->chunks != mark.chunks) {
+        arena_chunk_t* chunk = arena->chunks;
+        arena->chunks = chunk->next;
+        chunk->next = arena->spare;
+        arena->spare = chunk;
+    }
+    arena->base = mark.base;
+    arena->size = mark.size;
+    arena->used = mark.used;
+}
+
+void arena_reset(arena_t* arena) {
+    // Spare chunks held part of the last frame too, so they count towards its size
+    while (arena->spare) {
+        arena_chunk_t* chunk = arena->spare;
+        arena->spare = chunk->next;
+        chunk->next = arena->chunks;
+        arena->chunks = chunk;
+    }
+
+    arena_chunk_t* chunk = arena->chunks;
+
+    // Several chunks mean the last frame outgrew the arena: merge them into one
+    if (chunk && chunk->next) {
+        size_t total = arena->buffer_size;
+        while (chunk) {
+            arena_chunk_t* next = chunk->next;
+            total += chunk->size;
+            chunk_destroy(chunk);
+            chunk = next;
+        }
+        arena->chunks = chunk_create(total);
+    }
+
+    if (arena->chunks) {
+        arena->base = chunk_data(arena->chunks);
+        arena->size = arena->chunks->size;
+    } else {
+        arena->base = (unsigned char*)arena->buffer;
+        arena->size = arena->buffer_size;
+    }
+    arena->used = 0;
+}
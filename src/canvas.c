@@ -1,41 +1,302 @@
 #include "canvas.h"
+#include "simd.h"
+#include "stats.h"
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
 
+/* Aligned allocation helpers for the pixel block */
+static void* canvas_alloc_aligned(size_t size) {
+#ifdef _WIN32
+    return _aligned_malloc(size, CANVAS_ALIGNMENT);
+#else
+    void* ptr = NULL;
+    if (posix_memalign(&ptr, CANVAS_ALIGNMENT, size) != 0) return NULL;
+    return ptr;
+#endif
+}
+
+static void canvas_free_aligned(void* ptr) {
+#ifdef _WIN32
+    _aligned_free(ptr);
+#else
+    free(ptr);
+#endif
+}
+
+/* Per-format kernels. Every pointer is to the first pixel of a contiguous run. */
+struct canvas_ops {
+    void (*blend[CANVAS_BLEND_COUNT])(void* dst, const float* cov, size_t count);
+    void (*fill)(void* dst, size_t count, float brightness);
+    void (*scale_clamp)(void* dst, size_t count, float scale);
+    void (*read)(float* out, const void* src, size_t count);
+    void (*to_u8)(uint8_t* out, const void* src, size_t count);
+};
+
+/* Nearest unorm value of v, clamped to [0, max] */
+static inline int32_t unorm_quantize(float v, int32_t max) {
+    if (!(v > 0.0f)) return 0;   // Also maps NaN to 0
+    if (v >= 1.0f) return max;
+    return (int32_t)(v * (float)max + 0.5f);
+}
+
+/* Coverage delta as a signed unorm step; set_pixel_f may subtract */
+static inline int32_t unorm_delta(float v, int32_t max) {
+    return v < 0.0f ? -unorm_quantize(-v, max) : unorm_quantize(v, max);
+}
+
+// F32: the original float kernels
+static void blend_f32(void* dst, const float* cov, size_t count) {
+    float* p = (float*)dst;
+    for (size_t i = 0; i < count; i++) {
+        float v = p[i] + cov[i];
+        p[i] = v > 1.0f ? 1.0f : v;
+    }
+}
+
+// Plain add and max vectorize; clamping waits for resolve_canvas
+static void blend_add_f32(void* dst, const float* cov, size_t count) {
+    float* p = (float*)dst;
+    for (size_t i = 0; i < count; i++) p[i] += cov[i];
+}
+
+static void blend_max_f32(void* dst, const float* cov, size_t count) {
+    float* p = (float*)dst;
+    for (size_t i = 0; i < count; i++) p[i] = cov[i] > p[i] ? cov[i] : p[i];
+}
+
+// Uncovered pixels in a span have zero coverage and keep their value
+static void blend_replace_f32(void* dst, const float* cov, size_t count) {
+    float* p = (float*)dst;
+    for (size_t i = 0; i < count; i++) p[i] = cov[i] > 0.0f ? cov[i] : p[i];
+}
+
+static void fill_f32(void* dst, size_t count, float brightness) {
+    simd_fill_f32((float*)dst, count, brightness);
+}
+
+static void scale_clamp_f32(void* dst, size_t count, float scale) {
+    simd_scale_clamp_f32((float*)dst, (const float*)dst, count, scale);
+}
+
+static void read_f32(float* out, const void* src, size_t count) {
+    memcpy(out, src, count * sizeof(float));
+}
+
+static void to_u8_f32(uint8_t* out, const void* src, size_t count) {
+    simd_quantize_u8(out, (const float*)src, count);
+}
+
+// UNORM16
+static void blend_u16(void* dst, const float* cov, size_t count) {
+    uint16_t* p = (uint16_t*)dst;
+    for (size_t i = 0; i < count; i++) {
+        int32_t v = (int32_t)p[i] + unorm_delta(cov[i], 65535);
+        p[i] = (uint16_t)(v < 0 ? 0 : (v > 65535 ? 65535 : v));
+    }
+}
+
+static void blend_max_u16(void* dst, const float* cov, size_t count) {
+    uint16_t* p = (uint16_t*)dst;
+    for (size_t i = 0; i < count; i++) {
+        uint16_t v = (uint16_t)unorm_quantize(cov[i], 65535);
+        p[i] = v > p[i] ? v : p[i];
+    }
+}
+
+static void blend_replace_u16(void* dst, const float* cov, size_t count) {
+    uint16_t* p = (uint16_t*)dst;
+    for (size_t i = 0; i < count; i++) {
+        if (cov[i] > 0.0f) p[i] = (uint16_t)unorm_quantize(cov[i], 65535);
+    }
+}
+
+static void fill_u16(void* dst, size_t count, float brightness) {
+    uint16_t* p = (uint16_t*)dst;
+    uint16_t v = (uint16_t)unorm_quantize(brightness, 65535);
+    for (size_t i = 0; i < count; i++) p[i] = v;
+}
+
+static void scale_clamp_u16(void* dst, size_t count, float scale) {
+    uint16_t* p = (uint16_t*)dst;
+    for (size_t i = 0; i < count; i++) {
+        p[i] = (uint16_t)unorm_quantize(p[i] * (1.0f / 65535.0f) * scale, 65535);
+    }
+}
+
+static void read_u16(float* out, const void* src, size_t count) {
+    const uint16_t* p = (const uint16_t*)src;
+    for (size_t i = 0; i < count; i++) out[i] = p[i] * (1.0f / 65535.0f);
+}
+
+static void to_u8_u16(uint8_t* out, const void* src, size_t count) {
+    const uint16_t* p = (const uint16_t*)src;
+    // Exact rounding of v * 255 / 65535
+    for (size_t i = 0; i < count; i++) out[i] = (uint8_t)(((uint32_t)p[i] * 255u + 32767u) / 65535u);
+}
+
+// UNORM8
+static void blend_u8(void* dst, const float* cov, size_t count) {
+    uint8_t* p = (uint8_t*)dst;
+    for (size_t i = 0; i < count; i++) {
+        int32_t v = (int32_t)p[i] + unorm_delta(cov[i], 255);
+        p[i] = (uint8_t)(v < 0 ? 0 : (v > 255 ? 255 : v));
+    }
+}
+
+static void blend_max_u8(void* dst, const float* cov, size_t count) {
+    uint8_t* p = (uint8_t*)dst;
+    for (size_t i = 0; i < count; i++) {
+        uint8_t v = (uint8_t)unorm_quantize(cov[i], 255);
+        p[i] = v > p[i] ? v : p[i];
+    }
+}
+
+static void blend_replace_u8(void* dst, const float* cov, size_t count) {
+    uint8_t* p = (uint8_t*)dst;
+    for (size_t i = 0; i < count; i++) {
+        if (cov[i] > 0.0f) p[i] = (uint8_t)unorm_quantize(cov[i], 255);
+    }
+}
+
+static void fill_u8(void* dst, size_t count, float brightness) {
+    memset(dst, unorm_quantize(brightness, 255), count);
+}
+
+static void scale_clamp_u8(void* dst, size_t count, float scale) {
+    uint8_t* p = (uint8_t*)dst;
+    uint8_t table[256];
+    for (int v = 0; v < 256; v++) table[v] = (uint8_t)unorm_quantize(v * (1.0f / 255.0f) * scale, 255);
+    for (size_t i = 0; i < count; i++) p[i] = table[p[i]];
+}
+
+static void read_u8(float* out, const void* src, size_t count) {
+    const uint8_t* p = (const uint8_t*)src;
+    for (size_t i = 0; i < count; i++) out[i] = p[i] * (1.0f / 255.0f);
+}
+
+static void to_u8_u8(uint8_t* out, const void* src, size_t count) {
+    memcpy(out, src, count);
+}
+
+/* Unorm storage saturates by itself, so both add modes share one kernel */
+static const canvas_ops_t canvas_ops_table[] = {
+    [CANVAS_F32] = { { blend_f32, blend_add_f32, blend_max_f32, blend_replace_f32 },
+                     fill_f32, scale_clamp_f32, read_f32, to_u8_f32 },
+    [CANVAS_UNORM16] = { { blend_u16, blend_u16, blend_max_u16, blend_replace_u16 },
+                         fill_u16, scale_clamp_u16, read_u16, to_u8_u16 },
+    [CANVAS_UNORM8] = { { blend_u8, blend_u8, blend_max_u8, blend_replace_u8 },
+                        fill_u8, scale_clamp_u8, read_u8, to_u8_u8 },
+};
+
+static inline void* canvas_storage_at(const canvas_t* canvas, int x, int y) {
+    return (unsigned char*)canvas_row_storage(canvas, y) + (size_t)x * canvas_format_size(canvas->format);
+}
+
 canvas_t* create_canvas(int width, int height) {
-    canvas_t* canvas = (canvas_t*)malloc(sizeof(canvas_t));
+    return create_canvas_format(width, height, CANVAS_F32);
+}
+
+canvas_t* create_canvas_format(int width, int height, canvas_format_t format) {
+    if (width <= 0 || height <= 0) return NULL;
+    if (format != CANVAS_F32 && format != CANVAS_UNORM16 && format != CANVAS_UNORM8) return NULL;
+
+    canvas_t* canvas = (canvas_t*)calloc(1, sizeof(canvas_t));
+    if (!canvas) return NULL;
     canvas->width = width;
     canvas->height = height;
-    
-    // Allocate pixel rows
-    canvas->pixels = (float**)malloc(height * sizeof(float*));
-    
-    // Allocate each row
-    for (int y = 0; y < height; y++) {
-        canvas->pixels[y] = (float*)calloc(width, sizeof(float));
+    canvas->format = format;
+    canvas->ops = &canvas_ops_table[format];
+
+    // Round each row up to a whole number of cache lines
+    const size_t pixel_size = canvas_format_size(format);
+    const int pixels_per_line = CANVAS_ALIGNMENT / (int)pixel_size;
+    canvas->stride = (width + pixels_per_line - 1) / pixels_per_line * pixels_per_line;
+
+    // One block holds every row followed, for F32, by the row pointer table
+    size_t pixel_bytes = canvas_size(canvas) * pixel_size;
+    size_t table_bytes = format == CANVAS_F32 ? (size_t)height * sizeof(float*) : 0;
+    canvas->storage = canvas_alloc_aligned(pixel_bytes + table_bytes);
+    if (!canvas->storage) {
+        free(canvas);
+        return NULL;
     }
-    
+    memset(canvas->storage, 0, pixel_bytes);
+
+    if (format == CANVAS_F32) {
+        canvas->data = (float*)canvas->storage;
+        canvas->pixels = (float**)((unsigned char*)canvas->data + pixel_bytes);
+        for (int y = 0; y < height; y++) {
+            canvas->pixels[y] = canvas_row(canvas, y);
+        }
+    }
+
     return canvas;
 }
 
 void free_canvas(canvas_t* canvas) {
     if (!canvas) return;
-    
-    // Free each row
-    for (int y = 0; y < canvas->height; y++) {
-        free(canvas->pixels[y]);
-    }
-    
-    // Free row pointers
-    free(canvas->pixels);
+
+    // Row pointers live in the same block as the pixels
+    canvas_free_aligned(canvas->storage);
     free(canvas);
 }
 
+void destroy_canvas(canvas_t* canvas) {
+    free_canvas(canvas);
+}
+
+float canvas_get(const canvas_t* canvas, int x, int y) {
+    float v;
+    canvas->ops->read(&v, canvas_storage_at(canvas, x, y), 1);
+    return v;
+}
+
+const float* canvas_row_f32(const canvas_t* canvas, int y, float* scratch) {
+    if (canvas->format == CANVAS_F32) return canvas_row(canvas, y);
+    canvas->ops->read(scratch, canvas_row_storage(canvas, y), (size_t)canvas->width);
+    return scratch;
+}
+
 void clear_canvas(canvas_t* canvas, float brightness) {
+    if (!canvas) return;
+
+    // Rows are contiguous, so the whole block (padding included) is one pass
+    uint64_t start = stats_stage_begin();
+    canvas->ops->fill(canvas->storage, canvas_size(canvas), brightness);
+    stats_stage_end(TINY3D_STAGE_CLEAR, start, 0);
+}
+
+void fill_canvas_rect(canvas_t* canvas, int x, int y, int w, int h, float brightness) {
+    if (!canvas) return;
+
+    // Clip the rectangle to the canvas
+    int x0 = x < 0 ? 0 : x;
+    int y0 = y < 0 ? 0 : y;
+    int x1 = x + w > canvas->width ? canvas->width : x + w;
+    int y1 = y + h > canvas->height ? canvas->height : y + h;
+    if (x0 >= x1 || y0 >= y1) return;
+
+    for (int row = y0; row < y1; row++) {
+        canvas->ops->fill(canvas_storage_at(canvas, x0, row), (size_t)(x1 - x0), brightness);
+    }
+}
+
+void resolve_canvas(canvas_t* canvas, float scale) {
+    if (!canvas) return;
+    canvas->ops->scale_clamp(canvas->storage, canvas_size(canvas), scale);
+}
+
+void canvas_to_u8(const canvas_t* canvas, uint8_t* out, int out_stride) {
+    if (!canvas || !out) return;
+
+    // Tightly packed output converts in a single pass
+    if (out_stride == canvas->stride) {
+        canvas->ops->to_u8(out, canvas->storage, canvas_size(canvas));
+        return;
+    }
     for (int y = 0; y < canvas->height; y++) {
-        for (int x = 0; x < canvas->width; x++) {
-            canvas->pixels[y][x] = brightness;
-        }
+        canvas->ops->to_u8(out + (size_t)y * out_stride, canvas_row_storage(canvas, y), (size_t)canvas->width);
     }
 }
 
@@ -47,6 +308,10 @@ void set_pixel_f(canvas_t* canvas, float x, float y, float intensity) {
     int y0 = (int)floor(y);
     float dx = x - x0;
     float dy = y - y0;
+
+    // The default float canvas adds and clamps inline; other formats and modes use their kernel
+    int add_clamp_f32 = canvas->format == CANVAS_F32 && canvas->blend == CANVAS_BLEND_ADD_CLAMP;
+    void (*blend)(void*, const float*, size_t) = canvas->ops->blend[canvas->blend];
     
     // Distribute intensity to 4 neighboring pixels
     for (int i = 0; i <= 1; i++) {
@@ -56,39 +321,193 @@ void set_pixel_f(canvas_t* canvas, float x, float y, float intensity) {
             
             if (px >= 0 && px < canvas->width && py >= 0 && py < canvas->height) {
                 float weight = (i ? dx : 1-dx) * (j ? dy : 1-dy);
-                canvas->pixels[py][px] += intensity * weight;
-                
-                // Clamp to [0,1] range
-                if (canvas->pixels[py][px] > 1.0f) canvas->pixels[py][px] = 1.0f;
+                float amount = intensity * weight;
+
+                if (add_clamp_f32) {
+                    float* p = canvas_row(canvas, py) + px;
+                    float v = *p + amount;
+                    *p = v > 1.0f ? 1.0f : v;
+                } else {
+                    blend(canvas_storage_at(canvas, px, py), &amount, 1);
+                }
             }
         }
     }
 }
 
-void draw_line_f(canvas_t* canvas, float x0, float y0, float x1, float y1, float thickness) {
-    // DDA line algorithm implementation
-    float dx = x1 - x0;
-    float dy = y1 - y0;
-    float steps = fmax(fabs(dx), fabs(dy));
-    
-    float xInc = dx / steps;
-    float yInc = dy / steps;
-    
-    float x = x0;
-    float y = y0;
-    
-    for (int i = 0; i <= steps; i++) {
-        // Draw with thickness by drawing multiple pixels around the line
-        for (float t = -thickness/2; t <= thickness/2; t += 0.5f) {
-            for (float s = -thickness/2; s <= thickness/2; s += 0.5f) {
-                float dist = sqrt(t*t + s*s);
-                if (dist <= thickness/2) {
-                    set_pixel_f(canvas, x + t, y + s, 1.0f);
+/* Thick line as a capsule: the segment swept by a disk of the line's half
+ * thickness. Coverage of a pixel is how far its center sits inside the
+ * capsule, widened by half a pixel for the antialiased edge. */
+typedef struct {
+    float x0, y0;
+    float dx, dy;
+    float inv_len2;   // 1 / |d|^2, or 0 for a degenerate segment
+    float inv_len;    // 1 / |d|, or 0 for a degenerate segment
+    float reach;      // Half thickness + half a pixel: coverage is zero beyond it
+} capsule_t;
+
+static void capsule_init(capsule_t* c, float x0, float y0, float x1, float y1, float thickness) {
+    c->x0 = x0;
+    c->y0 = y0;
+    c->dx = x1 - x0;
+    c->dy = y1 - y0;
+    float len2 = c->dx * c->dx + c->dy * c->dy;
+    c->inv_len2 = len2 > 0.0f ? 1.0f / len2 : 0.0f;
+    c->inv_len = len2 > 0.0f ? 1.0f / sqrtf(len2) : 0.0f;
+    c->reach = 0.5f * thickness + 0.5f;
+}
+
+/* Coverage of the pixel centered at (px, py); *t_out gets the position of
+ * the nearest point along the segment, in [0,1] */
+static inline float capsule_coverage(const capsule_t* c, float px, float py, float* t_out) {
+    float rx = px - c->x0;
+    float ry = py - c->y0;
+    float t = (rx * c->dx + ry * c->dy) * c->inv_len2;
+    t = t < 0.0f ? 0.0f : (t > 1.0f ? 1.0f : t);
+    float ex = rx - t * c->dx;
+    float ey = ry - t * c->dy;
+    float cov = c->reach - sqrtf(ex * ex + ey * ey);
+    *t_out = t;
+    return cov > 1.0f ? 1.0f : cov;
+}
+
+/* Narrow [*lo, *hi] to the x where lo_v <= a*x + b <= hi_v */
+static int solve_linear_range(float a, float b, float lo_v, float hi_v, float* lo, float* hi) {
+    if (a == 0.0f) return b >= lo_v && b <= hi_v;
+    float xa = (lo_v - b) / a;
+    float xb = (hi_v - b) / a;
+    if (xa > xb) { float tmp = xa; xa = xb; xb = tmp; }
+    if (xa > *lo) *lo = xa;
+    if (xb < *hi) *hi = xb;
+    return *lo <= *hi;
+}
+
+/* Merge the chord of the circle (cx, cy, r) at height py into [*lo, *hi] */
+static void merge_circle_chord(float cx, float cy, float r, float py, float* lo, float* hi) {
+    float h = r * r - (py - cy) * (py - cy);
+    if (h < 0.0f) return;
+    h = sqrtf(h);
+    if (cx - h < *lo) *lo = cx - h;
+    if (cx + h > *hi) *hi = cx + h;
+}
+
+/* Horizontal extent of the capsule on row py; returns 0 if the row misses it.
+ * The capsule is convex, so its row section is one interval: the union of
+ * the two end-cap chords and the section of the straight band between them. */
+static int capsule_row_span(const capsule_t* c, float py, float* lo, float* hi) {
+    *lo = INFINITY;
+    *hi = -INFINITY;
+    merge_circle_chord(c->x0, c->y0, c->reach, py, lo, hi);
+    merge_circle_chord(c->x0 + c->dx, c->y0 + c->dy, c->reach, py, lo, hi);
+
+    if (c->inv_len2 > 0.0f) {
+        float ry = py - c->y0;
+        float band_lo = -INFINITY, band_hi = INFINITY;
+        // Projection onto the segment in [0,1], perpendicular distance within reach
+        if (solve_linear_range(c->dx * c->inv_len2, (ry * c->dy - c->x0 * c->dx) * c->inv_len2,
+                               0.0f, 1.0f, &band_lo, &band_hi) &&
+            solve_linear_range(c->dy * c->inv_len, -(c->x0 * c->dy + ry * c->dx) * c->inv_len,
+                               -c->reach, c->reach, &band_lo, &band_hi)) {
+            if (band_lo < *lo) *lo = band_lo;
+            if (band_hi > *hi) *hi = band_hi;
+        }
+    }
+    return *lo <= *hi;
+}
+
+/* Pixels whose coverage is gathered before one blend call */
+#define RASTER_SPAN_CHUNK 256
+
+/* Rasterize a capsule into the pixels of [min_x, max_x) x [min_y, max_y).
+ * Each covered pixel is visited exactly once and its value depends only on
+ * the segment, so clipping never changes the pixels that are drawn. A line
+ * with a depth buffer interpolates depth along the segment and skips the
+ * pixels that fail the depth test. Coverage is computed in float for a run
+ * of pixels and handed to the kernel for the canvas format and blend mode,
+ * so the geometry is the same for every combination. Returns the number of
+ * pixels with nonzero coverage. */
+static int raster_capsule(canvas_t* canvas, const capsule_t* c, const line_desc_t* line,
+                          int min_x, int min_y, int max_x, int max_y) {
+    float top = fminf(c->y0, c->y0 + c->dy) - c->reach;
+    float bottom = fmaxf(c->y0, c->y0 + c->dy) + c->reach;
+    if (!(top < (float)max_y && bottom > (float)min_y)) return 0;  // Also rejects NaN
+
+    int row0 = top > (float)min_y ? (int)ceilf(top) : min_y;
+    int row1 = bottom < (float)(max_y - 1) ? (int)floorf(bottom) : max_y - 1;
+    float* depth = line->depth;
+    float z0 = line->z0;
+    float dz = line->z1 - line->z0;
+    int shaded = line->shaded;
+    float i0 = line->i0;
+    float di = line->i1 - line->i0;
+    void (*blend)(void*, const float*, size_t) = canvas->ops->blend[canvas->blend];
+    float cov[RASTER_SPAN_CHUNK];
+    int written = 0;
+
+    for (int py = row0; py <= row1; py++) {
+        float lo, hi;
+        if (!capsule_row_span(c, (float)py, &lo, &hi)) continue;
+        if (!(lo < (float)max_x && hi > (float)min_x)) continue;
+
+        int col0 = lo > (float)min_x ? (int)ceilf(lo) : min_x;
+        int col1 = hi < (float)(max_x - 1) ? (int)floorf(hi) : max_x - 1;
+        float* zrow = depth ? depth + (size_t)py * line->depth_stride : NULL;
+
+        for (int chunk = col0; chunk <= col1; chunk += RASTER_SPAN_CHUNK) {
+            int n = col1 - chunk + 1 < RASTER_SPAN_CHUNK ? col1 - chunk + 1 : RASTER_SPAN_CHUNK;
+            for (int i = 0; i < n; i++) {
+                int px = chunk + i;
+                float t;
+                float a = capsule_coverage(c, (float)px, (float)py, &t);
+                if (a <= 0.0f) a = 0.0f;
+                else if (zrow) {
+                    float z = z0 + t * dz;
+                    if (!(z < zrow[px] + LINE_DEPTH_BIAS)) a = 0.0f;
+                    // Only the solid core occludes; antialiased fringes never hide later lines
+                    else if (a >= 0.5f && z < zrow[px]) zrow[px] = z;
                 }
+                cov[i] = shaded ? a * (i0 + t * di) : a;
+                written += a > 0.0f;
             }
+            blend(canvas_storage_at(canvas, chunk, py), cov, (size_t)n);
         }
-        
-        x += xInc;
-        y += yInc;
     }
-}
\ No newline at end of file
+    return written;
+}
+
+/* Clamp a clip rectangle to the canvas; returns 0 if nothing is left */
+static int clamp_rect(const canvas_t* canvas, int* min_x, int* min_y, int* max_x, int* max_y) {
+    if (*min_x < 0) *min_x = 0;
+    if (*min_y < 0) *min_y = 0;
+    if (*max_x > canvas->width) *max_x = canvas->width;
+    if (*max_y > canvas->height) *max_y = canvas->height;
+    return *min_x < *max_x && *min_y < *max_y;
+}
+
+void draw_line_f(canvas_t* canvas, float x0, float y0, float x1, float y1, float thickness) {
+    if (!canvas) return;
+
+    draw_line_clipped_f(canvas, x0, y0, x1, y1, thickness, 0, 0, canvas->width, canvas->height);
+}
+
+void draw_line_clipped_f(canvas_t* canvas, float x0, float y0, float x1, float y1, float thickness,
+                         int min_x, int min_y, int max_x, int max_y) {
+    line_desc_t line = {0};
+    line.x0 = x0;
+    line.y0 = y0;
+    line.x1 = x1;
+    line.y1 = y1;
+    line.thickness = thickness;
+    stats_count(TINY3D_COUNT_PIXELS, (uint64_t)draw_line_desc(canvas, &line, min_x, min_y, max_x, max_y));
+}
+
+int draw_line_desc(canvas_t* canvas, const line_desc_t* line,
+                   int min_x, int min_y, int max_x, int max_y) {
+    if (!canvas || !line) return 0;
+    if (!(line->thickness > 0.0f)) return 0;  // Also rejects NaN
+    if (!clamp_rect(canvas, &min_x, &min_y, &max_x, &max_y)) return 0;
+
+    capsule_t c;
+    capsule_init(&c, line->x0, line->y0, line->x1, line->y1, line->thickness);
+    return raster_capsule(canvas, &c, line, min_x, min_y, max_x, max_y);
+}
@@ -0,0 +1,111 @@
+#include "clip.h"
+#include <math.h>
+
+/* Trim the parameter range [*t_in, *t_out] by the half-space d(t) >= 0,
+ * where d is linear with d(0) = d0 and d(1) = d1 */
+static int clip_half_space(float d0, float d1, float* t_in, float* t_out) {
+    if (d0 < 0.0f && d1 < 0.0f) return 0;
+    if (d0 < 0.0f) {
+        float t = d0 / (d0 - d1);
+        if (t > *t_in) *t_in = t;
+    } else if (d1 < 0.0f) {
+        float t = d0 / (d0 - d1);
+        if (t < *t_out) *t_out = t;
+    }
+    return *t_in <= *t_out;
+}
+
+static void report_range(float t_in, float t_out, float* t0, float* t1) {
+    if (t0) *t0 = t_in;
+    if (t1) *t1 = t_out;
+}
+
+int clip_segment_homogeneous(vec4_t* a, vec4_t* b, int planes, float* t0, float* t1) {
+    float t_in = 0.0f, t_out = 1.0f;
+
+    // Signed distance to each plane is w +/- coordinate
+    if ((planes & CLIP_LEFT)   && !clip_half_space(a->w + a->x, b->w + b->x, &t_in, &t_out)) return 0;
+    if ((planes & CLIP_RIGHT)  && !clip_half_space(a->w - a->x, b->w - b->x, &t_in, &t_out)) return 0;
+    if ((planes & CLIP_BOTTOM) && !clip_half_space(a->w + a->y, b->w + b->y, &t_in, &t_out)) return 0;
+    if ((planes & CLIP_TOP)    && !clip_half_space(a->w - a->y, b->w - b->y, &t_in, &t_out)) return 0;
+    if ((planes & CLIP_NEAR)   && !clip_half_space(a->w + a->z, b->w + b->z, &t_in, &t_out)) return 0;
+    if ((planes & CLIP_FAR)    && !clip_half_space(a->w - a->z, b->w - b->z, &t_in, &t_out)) return 0;
+
+    vec4_t pa = *a, pb = *b;
+    if (t_in > 0.0f) {
+        a->x = pa.x + (pb.x - pa.x) * t_in;
+        a->y = pa.y + (pb.y - pa.y) * t_in;
+        a->z = pa.z + (pb.z - pa.z) * t_in;
+        a->w = pa.w + (pb.w - pa.w) * t_in;
+    }
+    if (t_out < 1.0f) {
+        b->x = pa.x + (pb.x - pa.x) * t_out;
+        b->y = pa.y + (pb.y - pa.y) * t_out;
+        b->z = pa.z + (pb.z - pa.z) * t_out;
+        b->w = pa.w + (pb.w - pa.w) * t_out;
+    }
+    report_range(t_in, t_out, t0, t1);
+    return 1;
+}
+
+/* Move both 2D endpoints to the parameters t_in and t_out */
+static void apply_range_2d(float* x0, float* y0, float* x1, float* y1, float t_in, float t_out) {
+    float dx = *x1 - *x0;
+    float dy = *y1 - *y0;
+    float ox = *x0, oy = *y0;
+    if (t_in > 0.0f) {
+        *x0 = ox + dx * t_in;
+        *y0 = oy + dy * t_in;
+    }
+    if (t_out < 1.0f) {
+        *x1 = ox + dx * t_out;
+        *y1 = oy + dy * t_out;
+    }
+}
+
+int clip_segment_rect(float* x0, float* y0, float* x1, float* y1,
+                      float min_x, float min_y, float max_x, float max_y,
+                      float* t0, float* t1) {
+    float t_in = 0.0f, t_out = 1.0f;
+
+    if (!clip_half_space(*x0 - min_x, *x1 - min_x, &t_in, &t_out)) return 0;
+    if (!clip_half_space(max_x - *x0, max_x - *x1, &t_in, &t_out)) return 0;
+    if (!clip_half_space(*y0 - min_y, *y1 - min_y, &t_in, &t_out)) return 0;
+    if (!clip_half_space(max_y - *y0, max_y - *y1, &t_in, &t_out)) return 0;
+
+    apply_range_2d(x0, y0, x1, y1, t_in, t_out);
+    report_range(t_in, t_out, t0, t1);
+    return 1;
+}
+
+int clip_segment_ellipse(float* x0, float* y0, float* x1, float* y1,
+                         float cx, float cy, float rx, float ry,
+                         float* t0, float* t1) {
+    if (rx <= 0.0f || ry <= 0.0f) return 0;
+
+    // Scale into unit-circle space, where the clip is |p + t*d|^2 <= 1
+    float px = (*x0 - cx) / rx, py = (*y0 - cy) / ry;
+    float dx = (*x1 - *x0) / rx, dy = (*y1 - *y0) / ry;
+    float a = dx*dx + dy*dy;
+    float b = px*dx + py*dy;
+    float c = px*px + py*py - 1.0f;
+
+    float t_in = 0.0f, t_out = 1.0f;
+    if (a <= 0.0f) {
+        // Degenerate segment: a point that is either inside or not
+        if (c > 0.0f) return 0;
+    } else {
+        float disc = b*b - a*c;
+        if (disc < 0.0f) return 0;
+        float root = sqrtf(disc);
+        float enter = (-b - root) / a;
+        float leave = (-b + root) / a;
+        if (enter > t_in) t_in = enter;
+        if (leave < t_out) t_out = leave;
+        if (t_in > t_out) return 0;
+    }
+
+    apply_range_2d(x0, y0, x1, y1, t_in, t_out);
+    report_range(t_in, t_out, t0, t1);
+    return 1;
+}
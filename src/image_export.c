@@ -0,0 +1,336 @@
+#include "image_export.h"
+#include "simd.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <io.h>
+#define write _write
+#define open _open
+#define close _close
+#else
+#include <unistd.h>
+#endif
+
+#ifndef O_BINARY
+#define O_BINARY 0
+#endif
+
+/* Bytes collected before each write() */
+#define EXPORT_BUFFER_SIZE (64 * 1024)
+
+/* Largest stored deflate block */
+#define DEFLATE_STORED_MAX 65535
+
+/* Buffered output plus the running checksums PNG needs */
+typedef struct {
+    int fd;
+    int failed;
+    size_t len;
+    uint32_t crc;             // CRC-32 of the current PNG chunk
+    uint32_t crc_table[256];
+    uint32_t adler_a;         // Adler-32 of the uncompressed zlib payload
+    uint32_t adler_b;
+    size_t block_left;        // Bytes left in the current stored block
+    size_t raw_left;          // Uncompressed bytes not yet written
+    unsigned char buf[EXPORT_BUFFER_SIZE];
+} export_stream_t;
+
+static void write_all(export_stream_t* s, const unsigned char* data, size_t len) {
+    while (len > 0 && !s->failed) {
+        long n = (long)write(s->fd, data, (unsigned)len);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            s->failed = 1;
+            return;
+        }
+        data += n;
+        len -= (size_t)n;
+    }
+}
+
+static void stream_flush(export_stream_t* s) {
+    write_all(s, s->buf, s->len);
+    s->len = 0;
+}
+
+static void stream_write(export_stream_t* s, const void* data, size_t len) {
+    if (s->len + len > EXPORT_BUFFER_SIZE) stream_flush(s);
+    if (len >= EXPORT_BUFFER_SIZE) {
+        write_all(s, (const unsigned char*)data, len);
+        return;
+    }
+    memcpy(s->buf + s->len, data, len);
+    s->len += len;
+}
+
+/* Everything an export needs, allocated once per image */
+typedef struct {
+    export_stream_t stream;
+    uint16_t* wide;      // 16-bit quantization scratch
+    float* row;          // Row converted from a unorm canvas
+    uint8_t* samples;    // One row of big-endian gray samples
+    uint8_t* rgb;        // One row expanded to three channels
+} export_ctx_t;
+
+static export_ctx_t* export_begin(const canvas_t* canvas, int fd, int bit_depth, int channels) {
+    if (!canvas || fd < 0 || (bit_depth != 8 && bit_depth != 16)) return NULL;
+
+    size_t width = (size_t)canvas->width;
+    size_t bytes = (size_t)bit_depth / 8;
+    export_ctx_t* ctx = (export_ctx_t*)malloc(sizeof(export_ctx_t));
+    if (!ctx) return NULL;
+    ctx->wide = (uint16_t*)malloc(width * sizeof(uint16_t));
+    ctx->samples = (uint8_t*)malloc(width * bytes);
+    ctx->rgb = channels > 1 ? (uint8_t*)malloc(width * bytes * channels) : NULL;
+    ctx->row = canvas->format != CANVAS_F32 ? (float*)malloc(width * sizeof(float)) : NULL;
+    if (!ctx->wide || !ctx->samples || (channels > 1 && !ctx->rgb) || (canvas->format != CANVAS_F32 && !ctx->row)) {
+        free(ctx->wide);
+        free(ctx->row);
+        free(ctx->samples);
+        free(ctx->rgb);
+        free(ctx);
+        return NULL;
+    }
+    ctx->stream.fd = fd;
+    ctx->stream.failed = 0;
+    ctx->stream.len = 0;
+    return ctx;
+}
+
+static int export_end(export_ctx_t* ctx) {
+    stream_flush(&ctx->stream);
+    int status = ctx->stream.failed ? -1 : 0;
+    free(ctx->wide);
+    free(ctx->row);
+    free(ctx->samples);
+    free(ctx->rgb);
+    free(ctx);
+    return status;
+}
+
+/* Quantize row y into ctx->samples; returns its size in bytes */
+static size_t quantize_row(export_ctx_t* ctx, const canvas_t* canvas, int y, int bit_depth) {
+    const float* row = canvas_row_f32(canvas, y, ctx->row);
+    size_t width = (size_t)canvas->width;
+    if (bit_depth == 8) {
+        simd_quantize_u8(ctx->samples, row, width);
+        return width;
+    }
+    simd_quantize_u16(ctx->wide, row, width);
+    for (size_t x = 0; x < width; x++) {
+        ctx->samples[2 * x] = (uint8_t)(ctx->wide[x] >> 8);
+        ctx->samples[2 * x + 1] = (uint8_t)ctx->wide[x];
+    }
+    return 2 * width;
+}
+
+/* Repeat every sample of the quantized row in three channels */
+static size_t expand_rgb(export_ctx_t* ctx, size_t row_bytes, int bit_depth) {
+    size_t bytes = (size_t)bit_depth / 8;
+    uint8_t* out = ctx->rgb;
+    for (size_t i = 0; i < row_bytes; i += bytes) {
+        for (int c = 0; c < 3; c++) {
+            memcpy(out, ctx->samples + i, bytes);
+            out += bytes;
+        }
+    }
+    return row_bytes * 3;
+}
+
+/* Binary PNM: a text header, then the rows as they are quantized */
+static int write_pnm(const canvas_t* canvas, int fd, int bit_depth, int channels) {
+    export_ctx_t* ctx = export_begin(canvas, fd, bit_depth, channels);
+    if (!ctx) return -1;
+
+    char header[64];
+    int n = snprintf(header, sizeof(header), "%s\n%d %d\n%d\n", channels == 3 ? "P6" : "P5",
+                     canvas->width, canvas->height, bit_depth == 8 ? 255 : 65535);
+    stream_write(&ctx->stream, header, (size_t)n);
+
+    for (int y = 0; y < canvas->height && !ctx->stream.failed; y++) {
+        size_t row_bytes = quantize_row(ctx, canvas, y, bit_depth);
+        if (channels == 3) {
+            stream_write(&ctx->stream, ctx->rgb, expand_rgb(ctx, row_bytes, bit_depth));
+        } else {
+            stream_write(&ctx->stream, ctx->samples, row_bytes);
+        }
+    }
+    return export_end(ctx);
+}
+
+int canvas_write_pgm(const canvas_t* canvas, int fd, int bit_depth) {
+    return write_pnm(canvas, fd, bit_depth, 1);
+}
+
+int canvas_write_ppm(const canvas_t* canvas, int fd, int bit_depth) {
+    return write_pnm(canvas, fd, bit_depth, 3);
+}
+
+/* PNG chunk framing: length, then CRC-32 over the type and data */
+static void crc_init_table(uint32_t* table) {
+    for (uint32_t n = 0; n < 256; n++) {
+        uint32_t c = n;
+        for (int k = 0; k < 8; k++) c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+        table[n] = c;
+    }
+}
+
+static void put_be32(unsigned char* p, uint32_t v) {
+    p[0] = (unsigned char)(v >> 24);
+    p[1] = (unsigned char)(v >> 16);
+    p[2] = (unsigned char)(v >> 8);
+    p[3] = (unsigned char)v;
+}
+
+static void chunk_data(export_stream_t* s, const void* data, size_t len) {
+    const unsigned char* p = (const unsigned char*)data;
+    uint32_t c = s->crc;
+    for (size_t i = 0; i < len; i++) c = s->crc_table[(c ^ p[i]) & 0xff] ^ (c >> 8);
+    s->crc = c;
+    stream_write(s, data, len);
+}
+
+static void chunk_begin(export_stream_t* s, const char* type, uint32_t len) {
+    unsigned char head[4];
+    put_be32(head, len);
+    stream_write(s, head, 4);
+    s->crc = 0xffffffffu;
+    chunk_data(s, type, 4);
+}
+
+static void chunk_end(export_stream_t* s) {
+    unsigned char tail[4];
+    put_be32(tail, s->crc ^ 0xffffffffu);
+    stream_write(s, tail, 4);
+}
+
+/* Uncompressed payload: split into stored blocks and summed with Adler-32 */
+static void zlib_stored(export_stream_t* s, const unsigned char* data, size_t len) {
+    while (len > 0) {
+        if (s->block_left == 0) {
+            size_t block = s->raw_left < DEFLATE_STORED_MAX ? s->raw_left : DEFLATE_STORED_MAX;
+            unsigned char head[5];
+            head[0] = block == s->raw_left ? 1 : 0;  // BFINAL on the last block, BTYPE 00
+            head[1] = (unsigned char)block;
+            head[2] = (unsigned char)(block >> 8);
+            head[3] = (unsigned char)~block;
+            head[4] = (unsigned char)(~block >> 8);
+            chunk_data(s, head, 5);
+            s->block_left = block;
+        }
+        size_t n = len < s->block_left ? len : s->block_left;
+
+        // Adler-32 sums stay below 2^32 for 5552 bytes between reductions
+        uint32_t a = s->adler_a, b = s->adler_b;
+        for (size_t done = 0; done < n; ) {
+            size_t step = n - done < 5552 ? n - done : 5552;
+            for (size_t i = 0; i < step; i++) {
+                a += data[done + i];
+                b += a;
+            }
+            a %= 65521u;
+            b %= 65521u;
+            done += step;
+        }
+        s->adler_a = a;
+        s->adler_b = b;
+
+        chunk_data(s, data, n);
+        data += n;
+        len -= n;
+        s->block_left -= n;
+        s->raw_left -= n;
+    }
+}
+
+int canvas_write_png(const canvas_t* canvas, int fd, int bit_depth) {
+    export_ctx_t* ctx = export_begin(canvas, fd, bit_depth, 1);
+    if (!ctx) return -1;
+    export_stream_t* s = &ctx->stream;
+
+    // Every size is known up front, so the single IDAT chunk is streamed
+    uint64_t row_bytes = (uint64_t)canvas->width * (bit_depth / 8) + 1;  // Filter byte first
+    uint64_t raw = row_bytes * (uint64_t)canvas->height;
+    uint64_t blocks = (raw + DEFLATE_STORED_MAX - 1) / DEFLATE_STORED_MAX;
+    uint64_t idat = 2 + blocks * 5 + raw + 4;
+    if (idat > 0x7fffffffu) {
+        s->failed = 1;
+        return export_end(ctx);
+    }
+    crc_init_table(s->crc_table);
+
+    static const unsigned char signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+    stream_write(s, signature, sizeof(signature));
+
+    unsigned char ihdr[13];
+    put_be32(ihdr, (uint32_t)canvas->width);
+    put_be32(ihdr + 4, (uint32_t)canvas->height);
+    ihdr[8] = (unsigned char)bit_depth;
+    ihdr[9] = 0;   // Grayscale
+    ihdr[10] = 0;  // Deflate
+    ihdr[11] = 0;  // Adaptive filtering (every row uses filter 0)
+    ihdr[12] = 0;  // No interlace
+    chunk_begin(s, "IHDR", sizeof(ihdr));
+    chunk_data(s, ihdr, sizeof(ihdr));
+    chunk_end(s);
+
+    chunk_begin(s, "IDAT", (uint32_t)idat);
+    static const unsigned char zlib_header[2] = {0x78, 0x01};
+    chunk_data(s, zlib_header, 2);
+    s->adler_a = 1;
+    s->adler_b = 0;
+    s->block_left = 0;
+    s->raw_left = (size_t)raw;
+    for (int y = 0; y < canvas->height && !s->failed; y++) {
+        static const unsigned char filter_none = 0;
+        size_t bytes = quantize_row(ctx, canvas, y, bit_depth);
+        zlib_stored(s, &filter_none, 1);
+        zlib_stored(s, ctx->samples, bytes);
+    }
+    unsigned char adler[4];
+    put_be32(adler, (s->adler_b << 16) | s->adler_a);
+    chunk_data(s, adler, 4);
+    chunk_end(s);
+
+    chunk_begin(s, "IEND", 0);
+    chunk_end(s);
+    return export_end(ctx);
+}
+
+static int has_extension(const char* path, const char* ext) {
+    size_t n = strlen(path), m = strlen(ext);
+    if (n < m) return 0;
+    for (size_t i = 0; i < m; i++) {
+        char c = path[n - m + i];
+        if (c >= 'A' && c <= 'Z') c = (char)(c - 'A' + 'a');
+        if (c != ext[i]) return 0;
+    }
+    return 1;
+}
+
+/* Open path for writing and hand it to one of the writers */
+static int save_with(int (*writer)(const canvas_t*, int, int), const canvas_t* canvas,
+                     const char* path, int bit_depth) {
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_BINARY, 0644);
+    if (fd < 0) return -1;
+    int status = writer(canvas, fd, bit_depth);
+    if (close(fd) != 0) status = -1;
+    return status;
+}
+
+int save_canvas(const canvas_t* canvas, const char* path, int bit_depth) {
+    if (!canvas || !path) return -1;
+    if (has_extension(path, ".png")) return save_with(canvas_write_png, canvas, path, bit_depth);
+    if (has_extension(path, ".ppm")) return save_with(canvas_write_ppm, canvas, path, bit_depth);
+    if (has_extension(path, ".pgm")) return save_with(canvas_write_pgm, canvas, path, bit_depth);
+    return -1;
+}
+
+int save_canvas_to_pgm(const canvas_t* canvas, const char* path) {
+    if (!canvas || !path) return -1;
+    return save_with(canvas_write_pgm, canvas, path, 8);
+}
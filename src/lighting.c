@@ -1,6 +1,18 @@
 #include "lighting.h"
+#include "simd.h"
 #include <math.h>
 
+#ifdef TINY3D_X86_SIMD
+#include <immintrin.h>
+#endif
+
+/* Keep multiply and add separate so every ISA rounds identically */
+#if defined(__clang__)
+#pragma STDC FP_CONTRACT OFF
+#elif defined(__GNUC__)
+#pragma GCC optimize("fp-contract=off")
+#endif
+
 /* Lambertian lighting calculation */
 float lambert_lighting(vec3_t edge_dir, vec3_t light_dir) {
     // Normalize both vectors
@@ -58,4 +70,139 @@ float calculate_edge_lighting(vec3_t v0, vec3_t v1, light_t* lights, int light_c
     vec3_t edge_dir = vec3_sub(v1, v0);
     vec3_t edge_normal = {edge_dir.y, -edge_dir.x, 0}; // Perpendicular in screen space
     return compute_lighting(edge_normal, lights, light_count);
-}
\ No newline at end of file
+}
+
+/* Light set */
+void light_set_init(light_set_t* set) {
+    set->count = 0;
+}
+
+int light_set_add(light_set_t* set, vec3_t direction, float intensity) {
+    float len2 = vec3_dot(direction, direction);
+    if (set->count >= MAX_LIGHTS || !(len2 > 0.0f)) return -1;
+
+    // Normalized exactly here, so shading never touches the directions again
+    float inv = 1.0f / sqrtf(len2);
+    int i = set->count++;
+    set->x[i] = direction.x * inv;
+    set->y[i] = direction.y * inv;
+    set->z[i] = direction.z * inv;
+    set->intensity[i] = intensity;
+    return i;
+}
+
+void light_set_remove(light_set_t* set, int index) {
+    if (index < 0 || index >= set->count) return;
+
+    for (int i = index; i < set->count - 1; i++) {
+        set->x[i] = set->x[i + 1];
+        set->y[i] = set->y[i + 1];
+        set->z[i] = set->z[i + 1];
+        set->intensity[i] = set->intensity[i + 1];
+    }
+    set->count--;
+}
+
+/* Scalar kernel; the vector kernels repeat its exact operation order */
+static void shade_scalar(const light_set_t* set, const float* nx, const float* ny, const float* nz,
+                         int begin, int end, float* out) {
+    for (int i = begin; i < end; i++) {
+        float len2 = nx[i] * nx[i] + ny[i] * ny[i] + nz[i] * nz[i];
+        float inv = len2 > 0.0f ? 1.0f / sqrtf(len2) : 0.0f;
+        float total = 0.0f;
+        for (int l = 0; l < set->count; l++) {
+            float c = (nx[i] * set->x[l] + ny[i] * set->y[l] + nz[i] * set->z[l]) * inv;
+            c = c > 0.0f ? c : 0.0f;
+            total = total + c * set->intensity[l];
+        }
+        total = total > 0.0f ? total : 0.0f;
+        out[i] = total < 1.0f ? total : 1.0f;
+    }
+}
+
+#ifdef TINY3D_X86_SIMD
+
+/* One lane block per ISA: V is the vector type, P the intrinsic prefix */
+#define DEFINE_SHADE_KERNEL(NAME, TARGET, WIDTH, V, P, POSITIVE)                           \
+__attribute__((target(TARGET)))                                                           \
+static int NAME(const light_set_t* set, const float* nx, const float* ny, const float* nz, \
+                int count, float* out) {                                                  \
+    const V zero = P##_setzero_ps(), one = P##_set1_ps(1.0f);                             \
+    int i = 0;                                                                            \
+    for (; i + WIDTH <= count; i += WIDTH) {                                              \
+        V x = P##_loadu_ps(nx + i), y = P##_loadu_ps(ny + i), z = P##_loadu_ps(nz + i);   \
+        V len2 = P##_add_ps(P##_add_ps(P##_mul_ps(x, x), P##_mul_ps(y, y)), P##_mul_ps(z, z)); \
+        V inv = POSITIVE(len2, zero, P##_div_ps(one, P##_sqrt_ps(len2)));                 \
+        V total = zero;                                                                   \
+        for (int l = 0; l < set->count; l++) {                                            \
+            V c = P##_add_ps(P##_add_ps(P##_mul_ps(x, P##_set1_ps(set->x[l])),            \
+                                        P##_mul_ps(y, P##_set1_ps(set->y[l]))),           \
+                             P##_mul_ps(z, P##_set1_ps(set->z[l])));                      \
+            c = P##_max_ps(P##_mul_ps(c, inv), zero);                                     \
+            total = P##_add_ps(total, P##_mul_ps(c, P##_set1_ps(set->intensity[l])));     \
+        }                                                                                 \
+        P##_storeu_ps(out + i, P##_min_ps(P##_max_ps(total, zero), one));                 \
+    }                                                                                     \
+    return i;                                                                             \
+}
+
+/* len2 > 0 ? v : 0 */
+#define POSITIVE_SSE2(len2, zero, v) _mm_and_ps(_mm_cmpgt_ps(len2, zero), v)
+#define POSITIVE_AVX2(len2, zero, v) _mm256_and_ps(_mm256_cmp_ps(len2, zero, _CMP_GT_OQ), v)
+#define POSITIVE_AVX512(len2, zero, v) _mm512_maskz_mov_ps(_mm512_cmp_ps_mask(len2, zero, _CMP_GT_OQ), v)
+
+DEFINE_SHADE_KERNEL(shade_sse2, "sse2", 4, __m128, _mm, POSITIVE_SSE2)
+DEFINE_SHADE_KERNEL(shade_avx2, "avx2", 8, __m256, _mm256, POSITIVE_AVX2)
+DEFINE_SHADE_KERNEL(shade_avx512, "avx512f", 16, __m512, _mm512, POSITIVE_AVX512)
+
+#endif // TINY3D_X86_SIMD
+
+void light_set_shade_soa(const light_set_t* set, const float* nx, const float* ny, const float* nz,
+                         int count, float* out) {
+    if (count <= 0) return;
+    int done = 0;
+
+#ifdef TINY3D_X86_SIMD
+    switch (simd_active_isa()) {
+    case TINY3D_ISA_AVX512:
+        done = shade_avx512(set, nx, ny, nz, count, out);
+        break;
+    case TINY3D_ISA_AVX2:
+        done = shade_avx2(set, nx, ny, nz, count, out);
+        break;
+    case TINY3D_ISA_SSE2:
+        done = shade_sse2(set, nx, ny, nz, count, out);
+        break;
+    default:
+        break;
+    }
+#endif
+
+    shade_scalar(set, nx, ny, nz, done, count, out);
+}
+
+float light_set_shade(const light_set_t* set, vec3_t normal) {
+    float out;
+    shade_scalar(set, &normal.x, &normal.y, &normal.z, 0, 1, &out);
+    return out;
+}
+
+/* Edges whose normals are gathered before each shading call */
+#define SHADE_EDGE_CHUNK 256
+
+void light_set_shade_edges(const light_set_t* set, const vec3_t* vertices, const int* edges,
+                           int edge_count, float* out) {
+    float nx[SHADE_EDGE_CHUNK], ny[SHADE_EDGE_CHUNK], nz[SHADE_EDGE_CHUNK];
+
+    for (int base = 0; base < edge_count; base += SHADE_EDGE_CHUNK) {
+        int n = edge_count - base < SHADE_EDGE_CHUNK ? edge_count - base : SHADE_EDGE_CHUNK;
+        for (int i = 0; i < n; i++) {
+            vec3_t a = vertices[edges[2 * (base + i)]];
+            vec3_t b = vertices[edges[2 * (base + i) + 1]];
+            nx[i] = b.y - a.y;   // Same perpendicular as calculate_edge_lighting
+            ny[i] = a.x - b.x;
+            nz[i] = 0.0f;
+        }
+        light_set_shade_soa(set, nx, ny, nz, n, out + base);
+    }
+}
@@ -1,4 +1,5 @@
 #include "math3d.h"
+#include "trig.h"
 #include <math.h>
 #include <stdint.h>
 #include <stdlib.h>
@@ -19,27 +20,33 @@ float Q_rsqrt(float number) {
 /* Vector operations */
 vec3_t vec3_from_spherical(float r, float theta, float phi) {
     vec3_t v;
-    v.r = r;
-    v.theta = theta;
-    v.phi = phi;
+    float sin_theta, cos_theta, sin_phi, cos_phi;
+    trig_sincos(theta, &sin_theta, &cos_theta, TINY3D_TRIG_DEFAULT);
+    trig_sincos(phi, &sin_phi, &cos_phi, TINY3D_TRIG_DEFAULT);
     
-    v.x = r * sinf(theta) * cosf(phi);
-    v.y = r * sinf(theta) * sinf(phi);
-    v.z = r * cosf(theta);
+    v.x = r * sin_theta * cos_phi;
+    v.y = r * sin_theta * sin_phi;
+    v.z = r * cos_theta;
     
     return v;
 }
 
+spherical_t vec3_to_spherical(vec3_t v) {
+    spherical_t s;
+    s.r = sqrtf(v.x*v.x + v.y*v.y + v.z*v.z);
+    s.theta = s.r > 0.0f ? trig_acos(fmaxf(-1.0f, fminf(1.0f, v.z / s.r)), TINY3D_TRIG_DEFAULT) : 0.0f;
+    s.phi = trig_atan2(v.y, v.x, TINY3D_TRIG_DEFAULT);
+    return s;
+}
+
 void vec3_normalize_fast(vec3_t* v) {
-    float inv_sqrt = Q_rsqrt(v->x*v->x + v->y*v->y + v->z*v->z);
+    float len2 = v->x*v->x + v->y*v->y + v->z*v->z;
+    if (len2 <= 0.0f) return;  // Leave zero vectors untouched
+    
+    float inv_sqrt = Q_rsqrt(len2);
     v->x *= inv_sqrt;
     v->y *= inv_sqrt;
     v->z *= inv_sqrt;
-    
-    // Update spherical coordinates
-    v->r = 1.0f;
-    v->theta = acosf(v->z);
-    v->phi = atan2f(v->y, v->x);
 }
 
 vec3_t vec3_slerp(vec3_t a, vec3_t b, float t) {
@@ -50,11 +57,13 @@ vec3_t vec3_slerp(vec3_t a, vec3_t b, float t) {
     float dot = vec3_dot(a, b);
     dot = fmaxf(-1.0f, fminf(1.0f, dot));
     
-    float theta = acosf(dot) * t;
+    float theta = trig_acos(dot, TINY3D_TRIG_DEFAULT) * t;
+    float sin_theta, cos_theta;
+    trig_sincos(theta, &sin_theta, &cos_theta, TINY3D_TRIG_DEFAULT);
     vec3_t relative = vec3_sub(b, vec3_scale(a, dot));
     vec3_normalize_fast(&relative);
     
-    vec3_t result = vec3_add(vec3_scale(a, cosf(theta)), vec3_scale(relative, sinf(theta)));
+    vec3_t result = vec3_add(vec3_scale(a, cos_theta), vec3_scale(relative, sin_theta));
     vec3_normalize_fast(&result);
     return result;
 }
@@ -85,25 +94,29 @@ mat4_t mat4_scale(float sx, float sy, float sz) {
     return m;
 }
 
+/* Rx * Ry * Rz written out: Z is applied first, as in
+ * mat4_mul(mat4_mul(Rz, Ry), Rx), without the two matrix products */
 mat4_t mat4_rotate_xyz(float rx, float ry, float rz) {
-    mat4_t mx = mat4_identity();
-    mat4_t my = mat4_identity();
-    mat4_t mz = mat4_identity();
+    float cx, sx, cy, sy, cz, sz;
+    trig_sincos(rx, &sx, &cx, TINY3D_TRIG_DEFAULT);
+    trig_sincos(ry, &sy, &cy, TINY3D_TRIG_DEFAULT);
+    trig_sincos(rz, &sz, &cz, TINY3D_TRIG_DEFAULT);
     
-    float cx = cosf(rx), sx = sinf(rx);
-    float cy = cosf(ry), sy = sinf(ry);
-    float cz = cosf(rz), sz = sinf(rz);
-    
-    mx.m[1][1] = cx; mx.m[2][1] = -sx;
-    mx.m[1][2] = sx; mx.m[2][2] = cx;
+    mat4_t m = {0};
+    m.m[0][0] = cy * cz;
+    m.m[1][0] = -cy * sz;
+    m.m[2][0] = sy;
     
-    my.m[0][0] = cy; my.m[2][0] = sy;
-    my.m[0][2] = -sy; my.m[2][2] = cy;
+    m.m[0][1] = cx * sz + sx * sy * cz;
+    m.m[1][1] = cx * cz - sx * sy * sz;
+    m.m[2][1] = -sx * cy;
     
-    mz.m[0][0] = cz; mz.m[1][0] = -sz;
-    mz.m[0][1] = sz; mz.m[1][1] = cz;
+    m.m[0][2] = sx * sz - cx * sy * cz;
+    m.m[1][2] = sx * cz + cx * sy * sz;
+    m.m[2][2] = cx * cy;
     
-    return mat4_mul(mat4_mul(mz, my), mx);
+    m.m[3][3] = 1.0f;
+    return m;
 }
 
 mat4_t mat4_frustum_asymmetric(float left, float right, float bottom, float top, float near, float far) {
@@ -177,6 +190,15 @@ vec3_t mat4_mul_vec3(mat4_t m, vec3_t v) {
     return result;
 }
 
+vec4_t mat4_mul_point(mat4_t m, vec3_t v) {
+    vec4_t result;
+    result.x = m.m[0][0]*v.x + m.m[1][0]*v.y + m.m[2][0]*v.z + m.m[3][0];
+    result.y = m.m[0][1]*v.x + m.m[1][1]*v.y + m.m[2][1]*v.z + m.m[3][1];
+    result.z = m.m[0][2]*v.x + m.m[1][2]*v.y + m.m[2][2]*v.z + m.m[3][2];
+    result.w = m.m[0][3]*v.x + m.m[1][3]*v.y + m.m[2][3]*v.z + m.m[3][3];
+    return result;
+}
+
 mat4_t mat4_mul(mat4_t a, mat4_t b) {
     mat4_t m;
     for (int i = 0; i < 4; i++) {
@@ -0,0 +1,339 @@
+#include "mesh.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/* The binary format stores vertices exactly as vec3_t lays them out */
+_Static_assert(sizeof(vec3_t) == 3 * sizeof(float), "vec3_t must be three packed floats");
+_Static_assert(sizeof(int) == sizeof(int32_t), "edges are stored as int32");
+
+#define MESH_BYTE_ORDER 0x01020304u
+#define MESH_SECTION_ALIGN 64
+
+/* Growable arrays used while parsing */
+typedef struct {
+    vec3_t* data;
+    int count;
+    int capacity;
+} vertex_list_t;
+
+typedef struct {
+    int* data;       // Index pairs
+    int count;       // Number of edges
+    int capacity;    // In edges
+} edge_list_t;
+
+/* Open-addressing set of undirected edges, keyed by (min, max) */
+typedef struct {
+    uint64_t* keys;  // 0 marks an empty slot (real keys are offset by one)
+    size_t capacity; // Power of two
+    size_t count;
+} edge_set_t;
+
+static int vertex_list_push(vertex_list_t* list, vec3_t v) {
+    if (list->count == list->capacity) {
+        int capacity = list->capacity ? list->capacity * 2 : 1024;
+        vec3_t* data = (vec3_t*)realloc(list->data, (size_t)capacity * sizeof(vec3_t));
+        if (!data) return -1;
+        list->data = data;
+        list->capacity = capacity;
+    }
+    list->data[list->count++] = v;
+    return 0;
+}
+
+static int edge_list_push(edge_list_t* list, int a, int b) {
+    if (list->count == list->capacity) {
+        int capacity = list->capacity ? list->capacity * 2 : 1024;
+        int* data = (int*)realloc(list->data, (size_t)capacity * 2 * sizeof(int));
+        if (!data) return -1;
+        list->data = data;
+        list->capacity = capacity;
+    }
+    list->data[list->count * 2] = a;
+    list->data[list->count * 2 + 1] = b;
+    list->count++;
+    return 0;
+}
+
+static size_t edge_hash(uint64_t key, size_t mask) {
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    return (size_t)key & mask;
+}
+
+static int edge_set_grow(edge_set_t* set) {
+    size_t capacity = set->capacity ? set->capacity * 2 : 4096;
+    uint64_t* keys = (uint64_t*)calloc(capacity, sizeof(uint64_t));
+    if (!keys) return -1;
+
+    for (size_t i = 0; i < set->capacity; i++) {
+        uint64_t key = set->keys[i];
+        if (!key) continue;
+        size_t slot = edge_hash(key, capacity - 1);
+        while (keys[slot]) slot = (slot + 1) & (capacity - 1);
+        keys[slot] = key;
+    }
+    free(set->keys);
+    set->keys = keys;
+    set->capacity = capacity;
+    return 0;
+}
+
+/* Returns 1 if the edge was new, 0 if already present, -1 on allocation failure */
+static int edge_set_insert(edge_set_t* set, int a, int b) {
+    if ((set->count + 1) * 2 > set->capacity && edge_set_grow(set) != 0) return -1;
+
+    uint32_t lo = (uint32_t)(a < b ? a : b);
+    uint32_t hi = (uint32_t)(a < b ? b : a);
+    uint64_t key = (((uint64_t)lo << 32) | hi) + 1;
+    size_t mask = set->capacity - 1;
+    size_t slot = edge_hash(key, mask);
+    while (set->keys[slot]) {
+        if (set->keys[slot] == key) return 0;
+        slot = (slot + 1) & mask;
+    }
+    set->keys[slot] = key;
+    set->count++;
+    return 1;
+}
+
+/* Read one line of any length into *buf, growing it as needed */
+static int read_line(FILE* f, char** buf, size_t* cap) {
+    size_t len = 0;
+    for (;;) {
+        if (len + 2 > *cap) {
+            size_t grown = *cap ? *cap * 2 : 4096;
+            char* b = (char*)realloc(*buf, grown);
+            if (!b) return -1;
+            *buf = b;
+            *cap = grown;
+        }
+        if (!fgets(*buf + len, (int)(*cap - len), f)) return len > 0 ? 1 : 0;
+        len += strlen(*buf + len);
+        if (len > 0 && (*buf)[len - 1] == '\n') return 1;
+    }
+}
+
+/* Resolve an OBJ index (1-based, or negative relative to the end) */
+static int resolve_index(long index, int vertex_count) {
+    // Range checks come first, so the negation and narrowing below cannot overflow
+    if (index > 0) return index <= (long)vertex_count ? (int)index - 1 : -1;
+    if (index < 0) return index >= -(long)vertex_count ? vertex_count + (int)index : -1;
+    return -1;
+}
+
+int mesh_load_obj(const char* path, mesh_t* mesh) {
+    if (!path || !mesh) return -1;
+    memset(mesh, 0, sizeof(*mesh));
+
+    FILE* f = fopen(path, "r");
+    if (!f) return -1;
+
+    vertex_list_t verts = {0};
+    edge_list_t edges = {0};
+    edge_set_t seen = {0};
+    char* line = NULL;
+    size_t cap = 0;
+    int status = 0, r;
+
+    while (status == 0 && (r = read_line(f, &line, &cap)) > 0) {
+        char* p = line;
+        while (*p == ' ' || *p == '\t') p++;
+
+        if (p[0] == 'v' && (p[1] == ' ' || p[1] == '\t')) {
+            vec3_t v = {0.0f, 0.0f, 0.0f};
+            char* end;
+            p += 2;
+            v.x = strtof(p, &end); p = end;
+            v.y = strtof(p, &end); p = end;
+            v.z = strtof(p, &end);
+            if (vertex_list_push(&verts, v) != 0) status = -1;
+        } else if ((p[0] == 'f' || p[0] == 'l') && (p[1] == ' ' || p[1] == '\t')) {
+            int closed = p[0] == 'f';
+            int first = -1, prev = -1;
+            char* end;
+            p += 2;
+            for (;;) {
+                long index = strtol(p, &end, 10);
+                if (end == p) break;
+                p = end;
+                while (*p && *p != ' ' && *p != '\t' && *p != '\r' && *p != '\n') p++;  // Skip /vt/vn
+
+                int cur = resolve_index(index, verts.count);
+                if (cur < 0) { status = -1; break; }
+                if (first < 0) first = cur;
+                if (prev >= 0 && prev != cur) {
+                    int fresh = edge_set_insert(&seen, prev, cur);
+                    if (fresh < 0 || (fresh && edge_list_push(&edges, prev, cur) != 0)) { status = -1; break; }
+                }
+                prev = cur;
+            }
+            if (status == 0 && closed && prev >= 0 && prev != first) {
+                int fresh = edge_set_insert(&seen, prev, first);
+                if (fresh < 0 || (fresh && edge_list_push(&edges, prev, first) != 0)) status = -1;
+            }
+        }
+    }
+    if (r < 0) status = -1;
+
+    free(line);
+    free(seen.keys);
+    fclose(f);
+
+    if (status != 0) {
+        free(verts.data);
+        free(edges.data);
+        return -1;
+    }
+
+    mesh->vertices = verts.data;
+    mesh->vertex_count = verts.count;
+    mesh->edges = edges.data;
+    mesh->edge_count = edges.count;
+    return 0;
+}
+
+static uint64_t align_offset(uint64_t offset) {
+    return (offset + MESH_SECTION_ALIGN - 1) & ~(uint64_t)(MESH_SECTION_ALIGN - 1);
+}
+
+static int write_padding(FILE* f, uint64_t from, uint64_t to) {
+    static const char zeros[MESH_SECTION_ALIGN] = {0};
+    return to > from && fwrite(zeros, 1, (size_t)(to - from), f) != (size_t)(to - from) ? -1 : 0;
+}
+
+int mesh_save_binary(const char* path, const mesh_t* mesh) {
+    if (!path || !mesh || mesh->vertex_count < 0 || mesh->edge_count < 0) return -1;
+
+    mesh_binary_header_t header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, MESH_BINARY_MAGIC, 4);
+    header.version = MESH_BINARY_VERSION;
+    header.byte_order = MESH_BYTE_ORDER;
+    header.vertex_count = (uint32_t)mesh->vertex_count;
+    header.edge_count = (uint32_t)mesh->edge_count;
+    header.vertex_offset = align_offset(sizeof(header));
+    uint64_t vertex_bytes = (uint64_t)mesh->vertex_count * sizeof(vec3_t);
+    header.edge_offset = align_offset(header.vertex_offset + vertex_bytes);
+    uint64_t edge_bytes = (uint64_t)mesh->edge_count * 2 * sizeof(int32_t);
+
+    FILE* f = fopen(path, "wb");
+    if (!f) return -1;
+
+    int status = 0;
+    if (fwrite(&header, sizeof(header), 1, f) != 1 ||
+        write_padding(f, sizeof(header), header.vertex_offset) != 0 ||
+        (vertex_bytes && fwrite(mesh->vertices, (size_t)vertex_bytes, 1, f) != 1) ||
+        write_padding(f, header.vertex_offset + vertex_bytes, header.edge_offset) != 0 ||
+        (edge_bytes && fwrite(mesh->edges, (size_t)edge_bytes, 1, f) != 1)) {
+        status = -1;
+    }
+    if (fclose(f) != 0) status = -1;
+    return status;
+}
+
+/* Does a section of bytes at offset lie between the header and the end of
+ * the file? Written so no sum can wrap. */
+static int section_fits(uint64_t offset, uint64_t bytes, uint64_t file_size) {
+    return offset >= sizeof(mesh_binary_header_t) && offset <= file_size && bytes <= file_size - offset;
+}
+
+/* Check a header against the size of the file it came from */
+static int header_valid(const mesh_binary_header_t* h, uint64_t file_size) {
+    if (memcmp(h->magic, MESH_BINARY_MAGIC, 4) != 0) return 0;
+    if (h->version != MESH_BINARY_VERSION || h->byte_order != MESH_BYTE_ORDER) return 0;
+    if (h->vertex_count > (uint32_t)INT32_MAX || h->edge_count > (uint32_t)INT32_MAX / 2) return 0;
+    if (h->vertex_offset % MESH_SECTION_ALIGN || h->edge_offset % MESH_SECTION_ALIGN) return 0;
+
+    // Counts are below 2^31, so the byte sizes cannot overflow
+    uint64_t vertex_bytes = (uint64_t)h->vertex_count * sizeof(vec3_t);
+    uint64_t edge_bytes = (uint64_t)h->edge_count * 2 * sizeof(int32_t);
+    if (!section_fits(h->vertex_offset, vertex_bytes, file_size) ||
+        !section_fits(h->edge_offset, edge_bytes, file_size)) return 0;
+
+    // Both sections are now inside the file, so their ends cannot wrap either
+    int overlap = vertex_bytes && edge_bytes &&
+                  h->vertex_offset < h->edge_offset + edge_bytes &&
+                  h->edge_offset < h->vertex_offset + vertex_bytes;
+    return !overlap;
+}
+
+int mesh_map_binary(const char* path, mesh_t* mesh) {
+    if (!path || !mesh) return -1;
+    memset(mesh, 0, sizeof(*mesh));
+
+#ifndef _WIN32
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return -1;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (uint64_t)st.st_size < sizeof(mesh_binary_header_t)) {
+        close(fd);
+        return -1;
+    }
+    size_t size = (size_t)st.st_size;
+    void* base = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) return -1;
+#else
+    // No mmap: read the file into one block and use it the same way
+    FILE* f = fopen(path, "rb");
+    if (!f) return -1;
+    fseek(f, 0, SEEK_END);
+    long length = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    if (length < (long)sizeof(mesh_binary_header_t)) {
+        fclose(f);
+        return -1;
+    }
+    size_t size = (size_t)length;
+    void* base = malloc(size);
+    if (!base || fread(base, 1, size, f) != size) {
+        free(base);
+        fclose(f);
+        return -1;
+    }
+    fclose(f);
+#endif
+
+    const mesh_binary_header_t* h = (const mesh_binary_header_t*)base;
+    if (!header_valid(h, size)) {
+        mesh->mapping = base;
+        mesh->mapping_size = size;
+        mesh_free(mesh);
+        return -1;
+    }
+
+    mesh->vertices = (vec3_t*)((unsigned char*)base + h->vertex_offset);
+    mesh->vertex_count = (int)h->vertex_count;
+    mesh->edges = (int*)((unsigned char*)base + h->edge_offset);
+    mesh->edge_count = (int)h->edge_count;
+    mesh->mapping = base;
+    mesh->mapping_size = size;
+    return 0;
+}
+
+void mesh_free(mesh_t* mesh) {
+    if (!mesh) return;
+
+    if (mesh->mapping) {
+#ifndef _WIN32
+        munmap(mesh->mapping, mesh->mapping_size);
+#else
+        free(mesh->mapping);
+#endif
+    } else {
+        free(mesh->vertices);
+        free(mesh->edges);
+    }
+    memset(mesh, 0, sizeof(*mesh));
+}
@@ -0,0 +1,235 @@
+#include "presenter.h"
+#include "stats.h"
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <io.h>
+#define write _write
+#else
+#include <unistd.h>
+#endif
+
+/* Gray levels per half-block pixel: black, then the 24-step gray ramp 232..255 */
+#define PRESENTER_GRAY_LEVELS 25
+
+static const char HALF_BLOCK[] = "\xe2\x96\x80";  // U+2580 upper half block
+
+static int append(presenter_t* p, const char* data, size_t len) {
+    if (p->out_len + len > p->out_cap) {
+        size_t cap = p->out_cap ? p->out_cap : 4096;
+        while (cap < p->out_len + len) cap *= 2;
+        char* out = (char*)realloc(p->out, cap);
+        if (!out) return -1;
+        p->out = out;
+        p->out_cap = cap;
+    }
+    memcpy(p->out + p->out_len, data, len);
+    p->out_len += len;
+    return 0;
+}
+
+static int append_str(presenter_t* p, const char* s) {
+    return append(p, s, strlen(s));
+}
+
+int presenter_init(presenter_t* p, const presenter_config_t* config) {
+    memset(p, 0, sizeof(*p));
+    if (config) p->config = *config;
+
+    presenter_config_t* c = &p->config;
+    if (c->cols <= 0) c->cols = 40;
+    if (c->rows <= 0) c->rows = 40;
+    if (!c->ramp || !c->ramp[0]) c->ramp = " .+#";
+    if (c->cell_width <= 0) c->cell_width = 2;
+    if (c->origin_row <= 0) c->origin_row = 1;
+    if (c->origin_col <= 0) c->origin_col = 1;
+    if (c->fd <= 0) c->fd = 1;
+
+    size_t count = (size_t)c->cols * c->rows;
+    p->cells = (uint16_t*)malloc(count * sizeof(uint16_t));
+    p->shown = (uint16_t*)malloc(count * sizeof(uint16_t));
+    if (!p->cells || !p->shown) {
+        presenter_free(p);
+        return -1;
+    }
+
+    // Hide the cursor while frames are drawn
+    return append_str(p, "\x1b[?25l");
+}
+
+static long flush(presenter_t* p) {
+    size_t done = 0;
+    while (done < p->out_len) {
+        long n = (long)write(p->config.fd, p->out + done, (unsigned)(p->out_len - done));
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            p->out_len = 0;
+            return -1;
+        }
+        done += (size_t)n;
+    }
+    p->out_len = 0;
+    return (long)done;
+}
+
+void presenter_free(presenter_t* p) {
+    if (!p) return;
+    if (p->cells && p->shown) {
+        char buf[32];
+        snprintf(buf, sizeof(buf), "\x1b[0m\x1b[%d;1H\x1b[?25h", p->config.origin_row + p->config.rows);
+        append_str(p, buf);
+        flush(p);
+    }
+    free(p->cells);
+    free(p->shown);
+    free(p->out);
+    memset(p, 0, sizeof(*p));
+}
+
+void presenter_clear_screen(presenter_t* p) {
+    append_str(p, "\x1b[0m\x1b[2J");
+    p->shown_valid = 0;
+}
+
+void presenter_text(presenter_t* p, int row, const char* text) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "\x1b[0m\x1b[%d;1H\x1b[2K", row);
+    append_str(p, buf);
+    append_str(p, text);
+
+    // Text inside the cell area overwrites cells the diff assumes are shown
+    if (row >= p->config.origin_row && row < p->config.origin_row + p->config.rows) p->shown_valid = 0;
+}
+
+/* Brightest pixel in [x0, x1) x [y0, y1); unorm canvases compare raw values */
+static float region_max(const canvas_t* canvas, int x0, int y0, int x1, int y1) {
+    if (canvas->format == CANVAS_UNORM8 || canvas->format == CANVAS_UNORM16) {
+        int wide = canvas->format == CANVAS_UNORM16;
+        unsigned m = 0;
+        for (int y = y0; y < y1; y++) {
+            const void* row = canvas_row_storage(canvas, y);
+            for (int x = x0; x < x1; x++) {
+                unsigned v = wide ? ((const uint16_t*)row)[x] : ((const uint8_t*)row)[x];
+                if (v > m) m = v;
+            }
+        }
+        return (float)m / (wide ? 65535.0f : 255.0f);
+    }
+
+    float m = 0.0f;
+    for (int y = y0; y < y1; y++) {
+        const float* row = canvas_row(canvas, y);
+        for (int x = x0; x < x1; x++) {
+            if (row[x] > m) m = row[x];
+        }
+    }
+    return m;
+}
+
+static int quantize_level(float b, int levels) {
+    int level = (int)(b * (float)levels);
+    if (level < 0) return 0;
+    return level < levels ? level : levels - 1;
+}
+
+/* Reduce the canvas to one code per cell */
+static void build_cells(presenter_t* p, const canvas_t* canvas) {
+    const presenter_config_t* c = &p->config;
+    int sub_rows = c->mode == PRESENTER_HALF_BLOCK ? 2 : 1;
+    int levels = c->mode == PRESENTER_HALF_BLOCK ? PRESENTER_GRAY_LEVELS : (int)strlen(c->ramp);
+
+    for (int cy = 0; cy < c->rows; cy++) {
+        for (int cx = 0; cx < c->cols; cx++) {
+            int x0 = (int)((long long)cx * canvas->width / c->cols);
+            int x1 = (int)((long long)(cx + 1) * canvas->width / c->cols);
+            if (x1 <= x0) x1 = x0 + 1;
+            if (x1 > canvas->width) x1 = canvas->width;
+
+            uint16_t code = 0;
+            for (int s = 0; s < sub_rows; s++) {
+                int sy = cy * sub_rows + s, total = c->rows * sub_rows;
+                int y0 = (int)((long long)sy * canvas->height / total);
+                int y1 = (int)((long long)(sy + 1) * canvas->height / total);
+                if (y1 <= y0) y1 = y0 + 1;
+                if (y1 > canvas->height) y1 = canvas->height;
+                code = (uint16_t)((code << 8) | quantize_level(region_max(canvas, x0, y0, x1, y1), levels));
+            }
+            p->cells[cy * c->cols + cx] = code;
+        }
+    }
+}
+
+static int gray_color(int level) {
+    return level == 0 ? 16 : 231 + level;
+}
+
+static long present(presenter_t* p, const canvas_t* canvas) {
+    if (!p || !p->cells || !canvas || canvas->width <= 0 || canvas->height <= 0) return -1;
+    const presenter_config_t* c = &p->config;
+    build_cells(p, canvas);
+
+    int half = c->mode == PRESENTER_HALF_BLOCK;
+    int advance = half ? 1 : c->cell_width;
+    int cur_row = -1, cur_col = -1;   // Terminal cursor, when known
+    int fg = -1, bg = -1;             // Colors in effect, when known
+    char buf[48];
+
+    for (int cy = 0; cy < c->rows; cy++) {
+        for (int cx = 0; cx < c->cols; cx++) {
+            int i = cy * c->cols + cx;
+            uint16_t code = p->cells[i];
+            if (p->shown_valid && code == p->shown[i]) continue;
+
+            int row = c->origin_row + cy;
+            int col = c->origin_col + cx * advance;
+            if (row != cur_row || col != cur_col) {
+                snprintf(buf, sizeof(buf), "\x1b[%d;%dH", row, col);
+                if (append_str(p, buf) != 0) goto fail;
+            }
+
+            if (half) {
+                int top = gray_color(code >> 8), bottom = gray_color(code & 0xff);
+                if (top != fg || bottom != bg) {
+                    snprintf(buf, sizeof(buf), "\x1b[38;5;%d;48;5;%dm", top, bottom);
+                    if (append_str(p, buf) != 0) goto fail;
+                    fg = top;
+                    bg = bottom;
+                }
+                if (append(p, HALF_BLOCK, sizeof(HALF_BLOCK) - 1) != 0) goto fail;
+            } else {
+                for (int k = 0; k < c->cell_width; k++) {
+                    if (append(p, &c->ramp[code], 1) != 0) goto fail;
+                }
+            }
+            cur_row = row;
+            cur_col = col + advance;
+        }
+    }
+    if (fg >= 0 && append_str(p, "\x1b[0m") != 0) goto fail;
+
+    uint16_t* t = p->shown;
+    p->shown = p->cells;
+    p->cells = t;
+    p->shown_valid = 1;
+    return flush(p);
+
+fail:
+    // Out of memory: drop this frame and repaint everything next time
+    p->out_len = 0;
+    p->shown_valid = 0;
+    return -1;
+}
+
+long presenter_present(presenter_t* p, const canvas_t* canvas) {
+    uint64_t start = stats_stage_begin();
+    long result = present(p, canvas);
+    stats_stage_end(TINY3D_STAGE_PRESENT, start, 0);
+    return result;
+}
+
+long presenter_flush(presenter_t* p) {
+    return p ? flush(p) : -1;
+}
@@ -0,0 +1,176 @@
+#include "quat.h"
+#include "trig.h"
+#include <math.h>
+#include <stddef.h>
+
+/* Above this |dot| the arc is too short for slerp's division by sin(theta) */
+#define QUAT_SLERP_LINEAR 0.9995f
+
+/* Orientations interpolated per pass of the batched trig kernels */
+#define QUAT_SLERP_CHUNK 256
+
+quat_t quat_identity(void) {
+    quat_t q = {0.0f, 0.0f, 0.0f, 1.0f};
+    return q;
+}
+
+quat_t quat_from_axis_angle(vec3_t axis, float angle) {
+    float len2 = vec3_dot(axis, axis);
+    if (!(len2 > 0.0f)) return quat_identity();
+
+    float s, c;
+    trig_sincos(0.5f * angle, &s, &c, TINY3D_TRIG_DEFAULT);
+    float k = s / sqrtf(len2);
+    quat_t q = {axis.x * k, axis.y * k, axis.z * k, c};
+    return q;
+}
+
+quat_t quat_from_euler_xyz(float rx, float ry, float rz) {
+    // mat4_rotate_xyz applies Z, then Y, then X
+    quat_t qx = quat_from_axis_angle((vec3_t){1.0f, 0.0f, 0.0f}, rx);
+    quat_t qy = quat_from_axis_angle((vec3_t){0.0f, 1.0f, 0.0f}, ry);
+    quat_t qz = quat_from_axis_angle((vec3_t){0.0f, 0.0f, 1.0f}, rz);
+    return quat_mul(quat_mul(qz, qy), qx);
+}
+
+quat_t quat_mul(quat_t a, quat_t b) {
+    // Hamilton product b * a: the right-hand factor acts first
+    quat_t q;
+    q.w = b.w * a.w - b.x * a.x - b.y * a.y - b.z * a.z;
+    q.x = b.w * a.x + b.x * a.w + b.y * a.z - b.z * a.y;
+    q.y = b.w * a.y - b.x * a.z + b.y * a.w + b.z * a.x;
+    q.z = b.w * a.z + b.x * a.y - b.y * a.x + b.z * a.w;
+    return q;
+}
+
+quat_t quat_conjugate(quat_t q) {
+    quat_t r = {-q.x, -q.y, -q.z, q.w};
+    return r;
+}
+
+quat_t quat_normalize(quat_t q) {
+    float len2 = q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w;
+    if (!(len2 > 0.0f)) return quat_identity();
+    float inv = 1.0f / sqrtf(len2);
+    quat_t r = {q.x * inv, q.y * inv, q.z * inv, q.w * inv};
+    return r;
+}
+
+vec3_t quat_rotate_vec3(quat_t q, vec3_t v) {
+    // v + 2w(u x v) + 2u x (u x v), with u the vector part
+    vec3_t u = {q.x, q.y, q.z};
+    vec3_t uv = vec3_cross(u, v);
+    vec3_t uuv = vec3_cross(u, uv);
+    return vec3_add(v, vec3_add(vec3_scale(uv, 2.0f * q.w), vec3_scale(uuv, 2.0f)));
+}
+
+/* Rotation part of quat_to_mat4, written into m */
+static void quat_fill_mat4(float x, float y, float z, float w, mat4_t* m) {
+    float xx = x * x, yy = y * y, zz = z * z;
+    float xy = x * y, xz = x * z, yz = y * z;
+    float wx = w * x, wy = w * y, wz = w * z;
+
+    m->m[0][0] = 1.0f - 2.0f * (yy + zz);
+    m->m[0][1] = 2.0f * (xy + wz);
+    m->m[0][2] = 2.0f * (xz - wy);
+    m->m[0][3] = 0.0f;
+
+    m->m[1][0] = 2.0f * (xy - wz);
+    m->m[1][1] = 1.0f - 2.0f * (xx + zz);
+    m->m[1][2] = 2.0f * (yz + wx);
+    m->m[1][3] = 0.0f;
+
+    m->m[2][0] = 2.0f * (xz + wy);
+    m->m[2][1] = 2.0f * (yz - wx);
+    m->m[2][2] = 1.0f - 2.0f * (xx + yy);
+    m->m[2][3] = 0.0f;
+
+    m->m[3][0] = 0.0f;
+    m->m[3][1] = 0.0f;
+    m->m[3][2] = 0.0f;
+    m->m[3][3] = 1.0f;
+}
+
+mat4_t quat_to_mat4(quat_t q) {
+    mat4_t m;
+    quat_fill_mat4(q.x, q.y, q.z, q.w, &m);
+    return m;
+}
+
+quat_t quat_nlerp(quat_t a, quat_t b, float t) {
+    // Flip b onto a's hemisphere so the blend takes the shorter arc
+    float d = a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+    float wb = d < 0.0f ? -t : t;
+    float wa = 1.0f - t;
+    quat_t q = {wa * a.x + wb * b.x, wa * a.y + wb * b.y, wa * a.z + wb * b.z, wa * a.w + wb * b.w};
+    return quat_normalize(q);
+}
+
+quat_t quat_slerp(quat_t a, quat_t b, float t) {
+    // One-lane batch, so single and batched results agree exactly
+    quat_t out;
+    quat_soa_t sa = {&a.x, &a.y, &a.z, &a.w};
+    quat_soa_t sb = {&b.x, &b.y, &b.z, &b.w};
+    quat_soa_t so = {&out.x, &out.y, &out.z, &out.w};
+    quat_slerp_n(&sa, &sb, &t, &so, 1);
+    return out;
+}
+
+void quat_slerp_n(const quat_soa_t* a, const quat_soa_t* b, const float* t, const quat_soa_t* out, int count) {
+    float dot[QUAT_SLERP_CHUNK], theta[QUAT_SLERP_CHUNK];
+    float angle_a[QUAT_SLERP_CHUNK], angle_b[QUAT_SLERP_CHUNK];
+    float sin_a[QUAT_SLERP_CHUNK], sin_b[QUAT_SLERP_CHUNK], sin_theta[QUAT_SLERP_CHUNK];
+
+    for (int base = 0; base < count; base += QUAT_SLERP_CHUNK) {
+        int n = count - base < QUAT_SLERP_CHUNK ? count - base : QUAT_SLERP_CHUNK;
+        const float *ax = a->x + base, *ay = a->y + base, *az = a->z + base, *aw = a->w + base;
+        const float *bx = b->x + base, *by = b->y + base, *bz = b->z + base, *bw = b->w + base;
+        const float* tt = t + base;
+
+        // Branch-free passes around the batched acos and sin
+        for (int i = 0; i < n; i++) {
+            float d = fabsf(ax[i] * bx[i] + ay[i] * by[i] + az[i] * bz[i] + aw[i] * bw[i]);
+            dot[i] = d < 1.0f ? d : 1.0f;
+        }
+        trig_acos_n(dot, theta, n, TINY3D_TRIG_DEFAULT);
+        for (int i = 0; i < n; i++) {
+            angle_a[i] = (1.0f - tt[i]) * theta[i];
+            angle_b[i] = tt[i] * theta[i];
+        }
+        trig_sincos_n(angle_a, sin_a, NULL, n, TINY3D_TRIG_DEFAULT);
+        trig_sincos_n(angle_b, sin_b, NULL, n, TINY3D_TRIG_DEFAULT);
+        trig_sincos_n(theta, sin_theta, NULL, n, TINY3D_TRIG_DEFAULT);
+
+        for (int i = 0; i < n; i++) {
+            int linear = dot[i] > QUAT_SLERP_LINEAR;
+            float inv = linear ? 1.0f : 1.0f / sin_theta[i];
+            float wa = linear ? 1.0f - tt[i] : sin_a[i] * inv;
+            float wb = linear ? tt[i] : sin_b[i] * inv;
+            // Shorter arc: b joins a's hemisphere
+            if (ax[i] * bx[i] + ay[i] * by[i] + az[i] * bz[i] + aw[i] * bw[i] < 0.0f) wb = -wb;
+
+            float x = wa * ax[i] + wb * bx[i];
+            float y = wa * ay[i] + wb * by[i];
+            float z = wa * az[i] + wb * bz[i];
+            float w = wa * aw[i] + wb * bw[i];
+            // Exact for slerp up to rounding; required for the linear fallback
+            float len2 = x * x + y * y + z * z + w * w;
+            float k = len2 > 0.0f ? 1.0f / sqrtf(len2) : 0.0f;
+            out->x[base + i] = x * k;
+            out->y[base + i] = y * k;
+            out->z[base + i] = z * k;
+            out->w[base + i] = w * k;
+        }
+    }
+}
+
+void quat_to_mat4_n(const quat_soa_t* q, const vec3_t* positions, mat4_t* out, int count) {
+    for (int i = 0; i < count; i++) {
+        quat_fill_mat4(q->x[i], q->y[i], q->z[i], q->w[i], &out[i]);
+        if (positions) {
+            out[i].m[3][0] = positions[i].x;
+            out[i].m[3][1] = positions[i].y;
+            out[i].m[3][2] = positions[i].z;
+        }
+    }
+}
@@ -1,4 +1,8 @@
 #include "renderer.h"
+#include "transform.h"
+#include "clip.h"
+#include "simd.h"
+#include "stats.h"
 #include <math.h>
 #include <stdlib.h>
 
@@ -22,56 +26,586 @@ int clip_to_circular_viewport(canvas_t* canvas, float x, float y) {
     return (nx*nx + ny*ny) <= 1.0f;
 }
 
-/* Render wireframe model */
-void render_wireframe(
+/* Edge in canvas pixel coordinates, ready for the rasterizer */
+typedef struct {
+    float x0, y0, x1, y1;
+    float z0, z1;  // NDC depth at each end
+    float i0, i1;  // Light intensity at each end (lit mode)
+} screen_edge_t;
+
+/* Rasterization state shared by the serial and tiled paths */
+typedef struct {
+    canvas_t* canvas;
+    float thickness;
+    float reach;        // Capsule reach: half thickness plus the antialiased fringe
+    z_buffer_t* zbuf;   // Set in depth-tested mode
+    int lit;            // Scale coverage by the edges' intensities
+} edge_raster_t;
+
+/* Draw one edge into [min_x, max_x) x [min_y, max_y), depth testing if enabled.
+ * Returns the number of pixels written. */
+static int draw_screen_edge(const edge_raster_t* r, const screen_edge_t* e,
+                             int min_x, int min_y, int max_x, int max_y) {
+    line_desc_t line = {0};
+    line.x0 = e->x0;
+    line.y0 = e->y0;
+    line.x1 = e->x1;
+    line.y1 = e->y1;
+    line.thickness = r->thickness;
+    line.shaded = r->lit;
+    line.i0 = e->i0;
+    line.i1 = e->i1;
+    
+    if (!r->zbuf) return draw_line_desc(r->canvas, &line, min_x, min_y, max_x, max_y);
+    
+    // Pixel bounds of the capsule within the clip rectangle
+    int bx0 = (int)floorf(fminf(e->x0, e->x1) - r->reach);
+    int by0 = (int)floorf(fminf(e->y0, e->y1) - r->reach);
+    int bx1 = (int)ceilf(fmaxf(e->x0, e->x1) + r->reach) + 1;
+    int by1 = (int)ceilf(fmaxf(e->y0, e->y1) + r->reach) + 1;
+    if (bx0 < min_x) bx0 = min_x;
+    if (by0 < min_y) by0 = min_y;
+    if (bx1 > max_x) bx1 = max_x;
+    if (by1 > max_y) by1 = max_y;
+    
+    // Hierarchical-Z: skip the whole segment if it is behind everything there
+    if (z_buffer_region_occluded(r->zbuf, fminf(e->z0, e->z1), bx0, by0, bx1, by1)) return 0;
+    
+    line.z0 = e->z0;
+    line.z1 = e->z1;
+    line.depth = r->zbuf->buffer;
+    line.depth_stride = r->zbuf->width;
+    int written = draw_line_desc(r->canvas, &line, bx0, by0, bx1, by1);
+    z_buffer_mark_dirty(r->zbuf, bx0, by0, bx1, by1);
+    return written;
+}
+
+/* Viewport transform of a clip-space point with w > 0 */
+static void clip_to_screen(vec4_t p, float width, float height, float* x, float* y) {
+    float inv = 1.0f / p.w;
+    *x = (p.x * inv + 1.0f) * 0.5f * width;
+    *y = (1.0f - p.y * inv) * 0.5f * height;
+}
+
+/* Narrow the depth range to the clipped part [t0, t1] of a screen segment;
+ * NDC depth is affine in screen space, so plain interpolation is exact.
+ * Vertex intensities are narrowed the same way. */
+static void lerp_depth(float* z0, float* z1, float t0, float t1) {
+    float a = *z0, dz = *z1 - *z0;
+    *z0 = a + dz * t0;
+    *z1 = a + dz * t1;
+}
+
+/* Vertex positions split into arrays once, plus the per-transform results */
+typedef struct {
+    float* x;
+    float* y;
+    float* z;
+    float* screen_x;
+    float* screen_y;
+    float* depth;
+    float* clip_w;
+} vertex_soa_t;
+
+static int alloc_vertex_soa(arena_t* arena, vec3_t* vertices, int vertex_count, vertex_soa_t* soa) {
+    float* block = ARENA_ALLOC(arena, float, (size_t)vertex_count * 7);
+    if (!block) return 0;
+    soa->x = block;
+    soa->y = block + vertex_count;
+    soa->z = block + 2 * vertex_count;
+    soa->screen_x = block + 3 * vertex_count;
+    soa->screen_y = block + 4 * vertex_count;
+    soa->depth = block + 5 * vertex_count;
+    soa->clip_w = block + 6 * vertex_count;
+    vec3_to_soa(vertices, vertex_count, soa->x, soa->y, soa->z);
+    return 1;
+}
+
+/* Intensities from the light set, filled in by shade_model */
+typedef struct {
+    float* nx;            // Normal scratch, max(vertex_count, edge_count) each
+    float* ny;
+    float* nz;
+    float* values;
+    const float* edge;    // RENDER_LIGHT_EDGE: one per edge
+    const float* vertex;  // RENDER_LIGHT_VERTEX: one per vertex
+} shading_t;
+
+/* Scratch for shade_model; returns NULL when the options ask for no lighting */
+static shading_t* alloc_shading(arena_t* arena, const render_options_t* options,
+                                int vertex_count, int edge_count, shading_t* shading) {
+    if (!options || !options->lights) return NULL;
+    int n = vertex_count > edge_count ? vertex_count : edge_count;
+    float* block = ARENA_ALLOC(arena, float, (size_t)n * 4);
+    if (!block) return NULL;
+    shading->nx = block;
+    shading->ny = block + n;
+    shading->nz = block + 2 * n;
+    shading->values = block + 3 * n;
+    shading->edge = NULL;
+    shading->vertex = NULL;
+    return shading;
+}
+
+/* Light the model under an object-to-world transform (NULL: identity).
+ * Normals only need the linear part, and the light set normalizes them. */
+static void shade_model(shading_t* shading, const render_options_t* options, const mat4_t* model,
+                        const vertex_soa_t* soa, int vertex_count, int* edges, int edge_count) {
+    uint64_t start = stats_stage_begin();
+    mat4_t m = model ? *model : mat4_identity();
+    float* nx = shading->nx;
+    float* ny = shading->ny;
+    float* nz = shading->nz;
+    
+    if (options->lighting == RENDER_LIGHT_VERTEX) {
+        float cx = 0.0f, cy = 0.0f, cz = 0.0f;
+        for (int i = 0; i < vertex_count; i++) {
+            cx += soa->x[i];
+            cy += soa->y[i];
+            cz += soa->z[i];
+        }
+        cx /= (float)vertex_count;
+        cy /= (float)vertex_count;
+        cz /= (float)vertex_count;
+        
+        // Offsets from the centroid, rotated and scaled into world space
+        for (int i = 0; i < vertex_count; i++) {
+            float x = soa->x[i] - cx, y = soa->y[i] - cy, z = soa->z[i] - cz;
+            nx[i] = m.m[0][0]*x + m.m[1][0]*y + m.m[2][0]*z;
+            ny[i] = m.m[0][1]*x + m.m[1][1]*y + m.m[2][1]*z;
+            nz[i] = m.m[0][2]*x + m.m[1][2]*y + m.m[2][2]*z;
+        }
+        light_set_shade_soa(options->lights, nx, ny, nz, vertex_count, shading->values);
+        shading->vertex = shading->values;
+        stats_stage_end(TINY3D_STAGE_LIGHTING, start, 0);
+        return;
+    }
+    
+    for (int i = 0; i < edge_count; i++) {
+        int idx0 = edges[i*2];
+        int idx1 = edges[i*2+1];
+        nx[i] = ny[i] = nz[i] = 0.0f;
+        if (idx0 < 0 || idx0 >= vertex_count || idx1 < 0 || idx1 >= vertex_count) continue;
+        
+        // World-space edge direction, then the perpendicular calculate_edge_lighting uses
+        float x = soa->x[idx1] - soa->x[idx0];
+        float y = soa->y[idx1] - soa->y[idx0];
+        float z = soa->z[idx1] - soa->z[idx0];
+        float dx = m.m[0][0]*x + m.m[1][0]*y + m.m[2][0]*z;
+        float dy = m.m[0][1]*x + m.m[1][1]*y + m.m[2][1]*z;
+        nx[i] = dy;
+        ny[i] = -dx;
+    }
+    light_set_shade_soa(options->lights, nx, ny, nz, edge_count, shading->values);
+    shading->edge = shading->values;
+    stats_stage_end(TINY3D_STAGE_LIGHTING, start, 0);
+}
+
+/* Project the vertices and clip every edge against the near/far planes,
+ * the canvas and the circular viewport. Returns the number of visible
+ * edges written to out, which has room for edge_count. Lit edges carry
+ * the intensities of shading (may be NULL). */
+static int project_screen_edges(
     canvas_t* canvas,
     mat4_t mvp,
+    const vertex_soa_t* soa,
     vec3_t* vertices,
     int vertex_count,
     int* edges,
     int edge_count,
-    float thickness
+    float thickness,
+    const shading_t* shading,
+    screen_edge_t* out
 ) {
-    // Project all vertices first
-    float* screen_x = (float*)malloc(vertex_count * sizeof(float));
-    float* screen_y = (float*)malloc(vertex_count * sizeof(float));
+    // Project all vertices first, in one batch straight to pixel coordinates
+    float* screen_x = soa->screen_x;
+    float* screen_y = soa->screen_y;
+    float* depth = soa->depth;
+    float* clip_w = soa->clip_w;
+    int count = 0;
+    int clipped = 0;
     
-    for (int i = 0; i < vertex_count; i++) {
-        project_vertex(mvp, vertices[i], &screen_x[i], &screen_y[i]);
-    }
+    uint64_t start = stats_stage_begin();
+    transform_points_soa(&mvp, soa->x, soa->y, soa->z, vertex_count,
+                         (float)canvas->width, (float)canvas->height, screen_x, screen_y, depth, clip_w);
+    stats_stage_end(TINY3D_STAGE_TRANSFORM, start, 0);
+    stats_count(TINY3D_COUNT_VERTICES, (uint64_t)vertex_count);
+    start = stats_stage_begin();
+    
+    float width = (float)canvas->width;
+    float height = (float)canvas->height;
+    float reach = 0.5f * fabsf(thickness) + 0.5f;
     
-    // Draw each edge
     for (int i = 0; i < edge_count; i++) {
         int idx0 = edges[i*2];
         int idx1 = edges[i*2+1];
+        if (idx0 < 0 || idx0 >= vertex_count || idx1 < 0 || idx1 >= vertex_count) continue;
+        
+        float x0 = screen_x[idx0], y0 = screen_y[idx0];
+        float x1 = screen_x[idx1], y1 = screen_y[idx1];
+        float z0 = depth[idx0], z1 = depth[idx1];
+        float i0 = 1.0f, i1 = 1.0f;
+        float t0, t1;
+        int shortened = 0;
+        
+        if (shading && shading->vertex) {
+            i0 = shading->vertex[idx0];
+            i1 = shading->vertex[idx1];
+        } else if (shading && shading->edge) {
+            i0 = i1 = shading->edge[i];
+        }
+        
+        // Edges leaving the depth range are clipped before the divide
+        if (!(clip_w[idx0] > 0.0f && clip_w[idx1] > 0.0f &&
+              fabsf(depth[idx0]) <= 1.0f && fabsf(depth[idx1]) <= 1.0f)) {
+            vec4_t a = mat4_mul_point(mvp, vertices[idx0]);
+            vec4_t b = mat4_mul_point(mvp, vertices[idx1]);
+            if (!clip_segment_homogeneous(&a, &b, CLIP_DEPTH, &t0, &t1)) continue;
+            lerp_depth(&i0, &i1, t0, t1);
+            shortened |= t0 > 0.0f || t1 < 1.0f;
+            if (!(a.w > 0.0f && b.w > 0.0f)) continue;
+            clip_to_screen(a, width, height, &x0, &y0);
+            clip_to_screen(b, width, height, &x1, &y1);
+            z0 = a.z / a.w;
+            z1 = b.z / b.w;
+        }
+        
+        // The canvas is widened by the line's reach so no covered pixel is lost
+        if (!clip_segment_rect(&x0, &y0, &x1, &y1, -reach, -reach,
+                               width - 1.0f + reach, height - 1.0f + reach, &t0, &t1)) continue;
+        lerp_depth(&z0, &z1, t0, t1);
+        lerp_depth(&i0, &i1, t0, t1);
+        shortened |= t0 > 0.0f || t1 < 1.0f;
+        
+        // Circular viewport, an ellipse inscribed in the canvas
+        if (!clip_segment_ellipse(&x0, &y0, &x1, &y1, 0.5f * width, 0.5f * height,
+                                  0.5f * width, 0.5f * height, &t0, &t1)) continue;
+        lerp_depth(&z0, &z1, t0, t1);
+        lerp_depth(&i0, &i1, t0, t1);
+        clipped += shortened | (t0 > 0.0f || t1 < 1.0f);
+        
+        screen_edge_t* e = &out[count++];
+        e->x0 = x0;
+        e->y0 = y0;
+        e->x1 = x1;
+        e->y1 = y1;
+        e->z0 = z0;
+        e->z1 = z1;
+        e->i0 = i0;
+        e->i1 = i1;
+    }
+    
+    stats_stage_end(TINY3D_STAGE_CLIP, start, 0);
+    stats_count(TINY3D_COUNT_EDGES_SUBMITTED, (uint64_t)edge_count);
+    stats_count(TINY3D_COUNT_EDGES_CULLED, (uint64_t)(edge_count - count));
+    stats_count(TINY3D_COUNT_EDGES_CLIPPED, (uint64_t)clipped);
+    stats_count(TINY3D_COUNT_EDGES_DRAWN, (uint64_t)count);
+    return count;
+}
+
+/* Tile bins: edge indices per screen tile, each list in submission order */
+typedef struct {
+    edge_raster_t raster;
+    const screen_edge_t* edges;
+    int tiles_x;
+    int* bin_start;   // tiles + 1 offsets into bin_edges
+    int* bin_edges;
+    int* work;        // Non-empty tiles, in tile order
+} tile_job_t;
+
+/* Does the line's capsule possibly reach any pixel of the tile? */
+static int edge_touches_tile(const screen_edge_t* e, float reach, int tx0, int ty0, int tx1, int ty1) {
+    // Pixel centers sit on integer coordinates, so the tile spans [tx0, tx1 - 1]
+    float cx = 0.5f * (float)(tx0 + tx1 - 1);
+    float cy = 0.5f * (float)(ty0 + ty1 - 1);
+    float hx = 0.5f * (float)(tx1 - tx0 - 1);
+    float hy = 0.5f * (float)(ty1 - ty0 - 1);
+    
+    float dx = e->x1 - e->x0;
+    float dy = e->y1 - e->y0;
+    float len2 = dx*dx + dy*dy;
+    float t = len2 > 0.0f ? ((cx - e->x0)*dx + (cy - e->y0)*dy) / len2 : 0.0f;
+    t = fmaxf(0.0f, fminf(1.0f, t));
+    float ex = cx - (e->x0 + t*dx);
+    float ey = cy - (e->y0 + t*dy);
+    float limit = reach + sqrtf(hx*hx + hy*hy) + 1.0f;
+    return ex*ex + ey*ey <= limit*limit;
+}
+
+static void render_tile(void* ctx, int task, int worker) {
+    tile_job_t* job = (tile_job_t*)ctx;
+    int tile = job->work[task];
+    int tx0 = (tile % job->tiles_x) * RENDER_TILE_SIZE;
+    int ty0 = (tile / job->tiles_x) * RENDER_TILE_SIZE;
+    uint64_t start = stats_stage_begin();
+    uint64_t written = 0;
+    
+    for (int i = job->bin_start[tile]; i < job->bin_start[tile + 1]; i++) {
+        written += draw_screen_edge(&job->raster, &job->edges[job->bin_edges[i]],
+                                    tx0, ty0, tx0 + RENDER_TILE_SIZE, ty0 + RENDER_TILE_SIZE);
+    }
+    // One update per tile keeps workers off the shared counters
+    stats_count(TINY3D_COUNT_PIXELS, written);
+    stats_stage_end(TINY3D_STAGE_RASTER, start, worker + 1);
+}
+
+/* Visit the tiles each edge may touch, either counting or filling the bins */
+static void bin_edges(const tile_job_t* job, int count, int tiles_y, int* cursor, int fill) {
+    canvas_t* canvas = job->raster.canvas;
+    float reach = job->raster.reach;
+    
+    for (int i = 0; i < count; i++) {
+        const screen_edge_t* e = &job->edges[i];
+        float min_x = fminf(e->x0, e->x1) - reach, max_x = fmaxf(e->x0, e->x1) + reach;
+        float min_y = fminf(e->y0, e->y1) - reach, max_y = fmaxf(e->y0, e->y1) + reach;
+        if (!(max_x >= 0.0f && min_x < (float)canvas->width &&
+              max_y >= 0.0f && min_y < (float)canvas->height)) continue;
+        
+        int cx0 = min_x > 0.0f ? (int)min_x / RENDER_TILE_SIZE : 0;
+        int cy0 = min_y > 0.0f ? (int)min_y / RENDER_TILE_SIZE : 0;
+        int cx1 = max_x < (float)canvas->width ? (int)max_x / RENDER_TILE_SIZE : job->tiles_x - 1;
+        int cy1 = max_y < (float)canvas->height ? (int)max_y / RENDER_TILE_SIZE : tiles_y - 1;
+        
+        for (int ty = cy0; ty <= cy1; ty++) {
+            for (int tx = cx0; tx <= cx1; tx++) {
+                int px0 = tx * RENDER_TILE_SIZE, py0 = ty * RENDER_TILE_SIZE;
+                int px1 = px0 + RENDER_TILE_SIZE, py1 = py0 + RENDER_TILE_SIZE;
+                if (px1 > canvas->width) px1 = canvas->width;
+                if (py1 > canvas->height) py1 = canvas->height;
+                if (!edge_touches_tile(e, reach, px0, py0, px1, py1)) continue;
+                
+                int tile = ty * job->tiles_x + tx;
+                if (fill) job->bin_edges[cursor[tile]++] = i;
+                else cursor[tile]++;
+            }
+        }
+    }
+}
+
+/* Bin the edges into tiles and rasterize the tiles on the pool */
+static void render_tiled(
+    arena_t* arena,
+    thread_pool_t* pool,
+    const edge_raster_t* raster,
+    const screen_edge_t* list,
+    int count
+) {
+    canvas_t* canvas = raster->canvas;
+    tile_job_t job;
+    job.raster = *raster;
+    job.edges = list;
+    job.tiles_x = (canvas->width + RENDER_TILE_SIZE - 1) / RENDER_TILE_SIZE;
+    int tiles_y = (canvas->height + RENDER_TILE_SIZE - 1) / RENDER_TILE_SIZE;
+    int tiles = job.tiles_x * tiles_y;
+    
+    // Counting pass, prefix sum, then fill: bins keep edges in submission order
+    int* cursor = ARENA_ALLOC(arena, int, tiles);
+    job.bin_start = ARENA_ALLOC(arena, int, tiles + 1);
+    job.work = ARENA_ALLOC(arena, int, tiles);
+    if (!cursor || !job.bin_start || !job.work) return;
+    for (int t = 0; t < tiles; t++) cursor[t] = 0;
+    bin_edges(&job, count, tiles_y, cursor, 0);
+    
+    int total = 0, work_count = 0;
+    for (int t = 0; t < tiles; t++) {
+        job.bin_start[t] = total;
+        if (cursor[t] > 0) job.work[work_count++] = t;
+        total += cursor[t];
+        cursor[t] = job.bin_start[t];
+    }
+    job.bin_start[tiles] = total;
+    
+    job.bin_edges = ARENA_ALLOC(arena, int, total);
+    if (!job.bin_edges) return;
+    bin_edges(&job, count, tiles_y, cursor, 1);
+    
+    // Tiles share no pixels, so workers need no locking
+    thread_pool_run(pool, work_count, render_tile, &job);
+}
+
+/* Rasterization state for a canvas and the caller's options */
+static void init_edge_raster(edge_raster_t* raster, canvas_t* canvas, float thickness,
+                             const render_options_t* options) {
+    raster->canvas = canvas;
+    raster->thickness = thickness;
+    raster->reach = 0.5f * fabsf(thickness) + 0.5f;
+    raster->zbuf = options ? options->zbuf : NULL;
+    raster->lit = options && options->lights;
+    if (raster->zbuf && (!raster->zbuf->buffer || raster->zbuf->width != canvas->width ||
+                         raster->zbuf->height != canvas->height)) {
+        raster->zbuf = NULL;  // A missing or mismatched depth buffer cannot be addressed per pixel
+    }
+}
+
+/* Draw a list of screen edges in order, on the pool's tiles if it has workers */
+static void rasterize_edges(arena_t* arena, thread_pool_t* pool, const edge_raster_t* raster,
+                            const screen_edge_t* list, int count) {
+    uint64_t start = stats_stage_begin();
+    if (thread_pool_size(pool) > 1) {
+        render_tiled(arena, pool, raster, list, count);
+    } else {
+        // Draw each edge
+        uint64_t written = 0;
+        for (int i = 0; i < count; i++) {
+            written += draw_screen_edge(raster, &list[i], 0, 0, raster->canvas->width, raster->canvas->height);
+        }
+        stats_count(TINY3D_COUNT_PIXELS, written);
+    }
+    stats_stage_end(TINY3D_STAGE_RASTER, start, 0);
+}
+
+/* Render wireframe model with optional arena and worker pool */
+void render_wireframe_ex(
+    canvas_t* canvas,
+    mat4_t mvp,
+    vec3_t* vertices,
+    int vertex_count,
+    int* edges,
+    int edge_count,
+    float thickness,
+    const render_options_t* options
+) {
+    if (!canvas || vertex_count <= 0 || edge_count <= 0) return;
+    stats_canvas(canvas->width, canvas->height);
+    
+    // Without a caller arena, scratch for small models stays on the stack
+    unsigned char local_buffer[RENDER_LOCAL_SCRATCH];
+    arena_t local;
+    arena_t* arena = options ? options->arena : NULL;
+    if (!arena) {
+        arena_init(&local, local_buffer, sizeof(local_buffer));
+        arena = &local;
+    }
+    
+    vertex_soa_t soa;
+    shading_t shading_storage;
+    screen_edge_t* list = ARENA_ALLOC(arena, screen_edge_t, edge_count);
+    if (list && alloc_vertex_soa(arena, vertices, vertex_count, &soa)) {
+        // Lighting runs on the arrays the transform already uses
+        shading_t* shading = alloc_shading(arena, options, vertex_count, edge_count, &shading_storage);
+        if (shading) shade_model(shading, options, options->model, &soa, vertex_count, edges, edge_count);
+        int count = project_screen_edges(canvas, mvp, &soa, vertices, vertex_count, edges, edge_count,
+                                         thickness, shading, list);
+        edge_raster_t raster;
+        init_edge_raster(&raster, canvas, thickness, options);
+        rasterize_edges(arena, options ? options->pool : NULL, &raster, list, count);
+    }
+    
+    if (arena == &local) arena_free(&local);
+}
+
+/* Render many instances of one model
+ * The vertices are split into arrays once and every instance is projected
+ * from them; visible edges of consecutive instances are gathered into one
+ * list, up to RENDER_INSTANCE_BATCH_EDGES, and rasterized together. */
+void render_wireframe_instanced(
+    canvas_t* canvas,
+    mat4_t view_proj,
+    vec3_t* vertices,
+    int vertex_count,
+    int* edges,
+    int edge_count,
+    const mat4_t* models,
+    int instance_count,
+    float thickness,
+    const render_options_t* options
+) {
+    if (!canvas || !models || instance_count <= 0 || vertex_count <= 0 || edge_count <= 0) return;
+    stats_canvas(canvas->width, canvas->height);
+    
+    unsigned char local_buffer[RENDER_LOCAL_SCRATCH];
+    arena_t local;
+    arena_t* arena = options ? options->arena : NULL;
+    if (!arena) {
+        arena_init(&local, local_buffer, sizeof(local_buffer));
+        arena = &local;
+    }
+    thread_pool_t* pool = options ? options->pool : NULL;
+    
+    // Room for whole instances only, so a batch never splits one
+    long long wanted = (long long)edge_count * instance_count;
+    int capacity = wanted < RENDER_INSTANCE_BATCH_EDGES ? (int)wanted : RENDER_INSTANCE_BATCH_EDGES;
+    if (capacity < edge_count) capacity = edge_count;
+    
+    vertex_soa_t soa;
+    shading_t shading_storage;
+    screen_edge_t* list = ARENA_ALLOC(arena, screen_edge_t, capacity);
+    if (list && alloc_vertex_soa(arena, vertices, vertex_count, &soa)) {
+        shading_t* shading = alloc_shading(arena, options, vertex_count, edge_count, &shading_storage);
+        edge_raster_t raster;
+        init_edge_raster(&raster, canvas, thickness, options);
         
-        if (idx0 >= 0 && idx0 < vertex_count && idx1 >= 0 && idx1 < vertex_count) {
-            float x0 = screen_x[idx0] * canvas->width;
-            float y0 = screen_y[idx0] * canvas->height;
-            float x1 = screen_x[idx1] * canvas->width;
-            float y1 = screen_y[idx1] * canvas->height;
-            
-            // Only draw if both endpoints are in circular viewport
-            if (clip_to_circular_viewport(canvas, screen_x[idx0], screen_y[idx0]) ||
-                clip_to_circular_viewport(canvas, screen_x[idx1], screen_y[idx1])) {
-                draw_line_f(canvas, x0, y0, x1, y1, thickness);
+        int count = 0;
+        for (int i = 0; i < instance_count; i++) {
+            if (count + edge_count > capacity) {
+                // Tile bins are scratch for one batch only
+                arena_mark_t mark = arena_mark(arena);
+                rasterize_edges(arena, pool, &raster, list, count);
+                arena_rewind(arena, mark);
+                count = 0;
             }
+            // mat4_mul(a, b) applies a first: object to world, then world to clip
+            mat4_t mvp = mat4_mul(models[i], view_proj);
+            if (shading) shade_model(shading, options, &models[i], &soa, vertex_count, edges, edge_count);
+            count += project_screen_edges(canvas, mvp, &soa, vertices, vertex_count, edges, edge_count,
+                                          thickness, shading, list + count);
         }
+        rasterize_edges(arena, pool, &raster, list, count);
     }
     
-    free(screen_x);
-    free(screen_y);
+    if (arena == &local) arena_free(&local);
+}
+
+/* Render wireframe model */
+void render_wireframe(
+    canvas_t* canvas,
+    mat4_t mvp,
+    vec3_t* vertices,
+    int vertex_count,
+    int* edges,
+    int edge_count,
+    float thickness
+) {
+    render_wireframe_ex(canvas, mvp, vertices, vertex_count, edges, edge_count, thickness, NULL);
+}
+
+/* Render wireframe model with tiles spread across a worker pool */
+void render_wireframe_parallel(
+    thread_pool_t* pool,
+    canvas_t* canvas,
+    mat4_t mvp,
+    vec3_t* vertices,
+    int vertex_count,
+    int* edges,
+    int edge_count,
+    float thickness
+) {
+    render_options_t options = {0};
+    options.pool = pool;
+    render_wireframe_ex(canvas, mvp, vertices, vertex_count, edges, edge_count, thickness, &options);
 }
 
 /* Depth buffer implementation (optional) */
 void init_z_buffer(z_buffer_t* zbuf, int width, int height) {
-    zbuf->width = width;
-    zbuf->height = height;
-    zbuf->buffer = (float*)malloc(width * height * sizeof(float));
-    
-    for (int i = 0; i < width*height; i++) {
-        zbuf->buffer[i] = 1.0f; // Initialize to far plane
+    zbuf->width = width > 0 ? width : 0;
+    zbuf->height = height > 0 ? height : 0;
+    zbuf->hiz_cols = (zbuf->width + Z_BUFFER_HIZ_TILE - 1) / Z_BUFFER_HIZ_TILE;
+    zbuf->hiz_rows = (zbuf->height + Z_BUFFER_HIZ_TILE - 1) / Z_BUFFER_HIZ_TILE;
+
+    size_t pixels = (size_t)zbuf->width * (size_t)zbuf->height;
+    size_t tiles = (size_t)zbuf->hiz_cols * (size_t)zbuf->hiz_rows;
+    zbuf->buffer = pixels ? (float*)malloc(pixels * sizeof(float)) : NULL;
+    zbuf->hiz = tiles ? (float*)malloc(tiles * sizeof(float)) : NULL;
+    zbuf->hiz_dirty = tiles ? (unsigned char*)malloc(tiles) : NULL;
+
+    // All or nothing: a NULL buffer tells callers the depth buffer is unusable
+    if (!zbuf->buffer || !zbuf->hiz || !zbuf->hiz_dirty) {
+        free_z_buffer(zbuf);
+        zbuf->width = zbuf->height = zbuf->hiz_cols = zbuf->hiz_rows = 0;
+        return;
     }
+
+    clear_z_buffer(zbuf);
 }
 
 void free_z_buffer(z_buffer_t* zbuf) {
@@ -79,6 +613,24 @@ void free_z_buffer(z_buffer_t* zbuf) {
         free(zbuf->buffer);
         zbuf->buffer = NULL;
     }
+    if (zbuf) {
+        free(zbuf->hiz);
+        free(zbuf->hiz_dirty);
+        zbuf->hiz = NULL;
+        zbuf->hiz_dirty = NULL;
+    }
+}
+
+void clear_z_buffer(z_buffer_t* zbuf) {
+    if (!zbuf || !zbuf->buffer) return;
+    
+    // Initialize to far plane
+    simd_fill_f32(zbuf->buffer, (size_t)zbuf->width * zbuf->height, 1.0f);
+    size_t tiles = (size_t)zbuf->hiz_cols * (size_t)zbuf->hiz_rows;
+    for (size_t i = 0; i < tiles; i++) {
+        zbuf->hiz[i] = 1.0f;
+        zbuf->hiz_dirty[i] = 0;
+    }
 }
 
 int z_buffer_test(z_buffer_t* zbuf, int x, int y, float depth) {
@@ -89,7 +641,73 @@ int z_buffer_test(z_buffer_t* zbuf, int x, int y, float depth) {
     int idx = y * zbuf->width + x;
     if (depth < zbuf->buffer[idx]) {
         zbuf->buffer[idx] = depth;
+        zbuf->hiz_dirty[(y / Z_BUFFER_HIZ_TILE) * zbuf->hiz_cols + x / Z_BUFFER_HIZ_TILE] = 1;
         return 1;
     }
     return 0;
-}
\ No newline at end of file
+}
+
+/* Clamp a pixel rectangle to the buffer and convert it to a tile range */
+static int hiz_tile_range(const z_buffer_t* zbuf, int x0, int y0, int x1, int y1,
+                          int* tx0, int* ty0, int* tx1, int* ty1) {
+    if (x0 < 0) x0 = 0;
+    if (y0 < 0) y0 = 0;
+    if (x1 > zbuf->width) x1 = zbuf->width;
+    if (y1 > zbuf->height) y1 = zbuf->height;
+    if (x0 >= x1 || y0 >= y1) return 0;
+    
+    *tx0 = x0 / Z_BUFFER_HIZ_TILE;
+    *ty0 = y0 / Z_BUFFER_HIZ_TILE;
+    *tx1 = (x1 - 1) / Z_BUFFER_HIZ_TILE;
+    *ty1 = (y1 - 1) / Z_BUFFER_HIZ_TILE;
+    return 1;
+}
+
+/* Recompute the farthest depth of one tile */
+static float hiz_refresh(z_buffer_t* zbuf, int tx, int ty) {
+    int x0 = tx * Z_BUFFER_HIZ_TILE, y0 = ty * Z_BUFFER_HIZ_TILE;
+    int x1 = x0 + Z_BUFFER_HIZ_TILE, y1 = y0 + Z_BUFFER_HIZ_TILE;
+    if (x1 > zbuf->width) x1 = zbuf->width;
+    if (y1 > zbuf->height) y1 = zbuf->height;
+    
+    float farthest = -INFINITY;
+    for (int y = y0; y < y1; y++) {
+        const float* row = zbuf->buffer + (size_t)y * zbuf->width;
+        for (int x = x0; x < x1; x++) {
+            if (row[x] > farthest) farthest = row[x];
+        }
+    }
+    int tile = ty * zbuf->hiz_cols + tx;
+    zbuf->hiz[tile] = farthest;
+    zbuf->hiz_dirty[tile] = 0;
+    return farthest;
+}
+
+int z_buffer_region_occluded(z_buffer_t* zbuf, float min_depth, int x0, int y0, int x1, int y1) {
+    int tx0, ty0, tx1, ty1;
+    if (!hiz_tile_range(zbuf, x0, y0, x1, y1, &tx0, &ty0, &tx1, &ty1)) return 1;
+    
+    // Occluded only if every pixel would fail the depth test in draw_line_desc
+    for (int ty = ty0; ty <= ty1; ty++) {
+        for (int tx = tx0; tx <= tx1; tx++) {
+            int tile = ty * zbuf->hiz_cols + tx;
+            float farthest = zbuf->hiz[tile];
+            if (min_depth < farthest + LINE_DEPTH_BIAS && zbuf->hiz_dirty[tile]) {
+                farthest = hiz_refresh(zbuf, tx, ty);
+            }
+            if (min_depth < farthest + LINE_DEPTH_BIAS) return 0;
+        }
+    }
+    return 1;
+}
+
+void z_buffer_mark_dirty(z_buffer_t* zbuf, int x0, int y0, int x1, int y1) {
+    int tx0, ty0, tx1, ty1;
+    if (!hiz_tile_range(zbuf, x0, y0, x1, y1, &tx0, &ty0, &tx1, &ty1)) return;
+    
+    for (int ty = ty0; ty <= ty1; ty++) {
+        for (int tx = tx0; tx <= tx1; tx++) {
+            zbuf->hiz_dirty[ty * zbuf->hiz_cols + tx] = 1;
+        }
+    }
+}
@@ -0,0 +1,319 @@
+#include "scene.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Relative slack on every cull test, so rounding can only keep a model */
+#define SCENE_CULL_EPSILON 1e-4f
+
+/* Traversal stack; a median-split tree over 2^31 models is 30 levels deep */
+#define SCENE_BVH_MAX_DEPTH 64
+
+static aabb_t aabb_empty(void) {
+    aabb_t box = {{INFINITY, INFINITY, INFINITY}, {-INFINITY, -INFINITY, -INFINITY}};
+    return box;
+}
+
+static void aabb_add_point(aabb_t* box, vec3_t p) {
+    box->min.x = fminf(box->min.x, p.x);
+    box->min.y = fminf(box->min.y, p.y);
+    box->min.z = fminf(box->min.z, p.z);
+    box->max.x = fmaxf(box->max.x, p.x);
+    box->max.y = fmaxf(box->max.y, p.y);
+    box->max.z = fmaxf(box->max.z, p.z);
+}
+
+static void aabb_add_box(aabb_t* box, const aabb_t* other) {
+    aabb_add_point(box, other->min);
+    aabb_add_point(box, other->max);
+}
+
+static vec3_t aabb_corner(const aabb_t* box, int i) {
+    vec3_t p;
+    p.x = (i & 1) ? box->max.x : box->min.x;
+    p.y = (i & 2) ? box->max.y : box->min.y;
+    p.z = (i & 4) ? box->max.z : box->min.z;
+    return p;
+}
+
+/* World bounds of a model: the transformed box, tightened by the bounding
+ * sphere, which is the better fit for round models under rotation */
+static void update_world_box(scene_model_t* m) {
+    aabb_t box = aabb_empty();
+    for (int i = 0; i < 8; i++) {
+        vec4_t p = mat4_mul_point(m->model, aabb_corner(&m->local_box, i));
+        aabb_add_point(&box, (vec3_t){p.x, p.y, p.z});
+    }
+
+    // A sphere scales by the longest transformed axis
+    float scale = 0.0f;
+    for (int c = 0; c < 3; c++) {
+        float len = sqrtf(m->model.m[c][0]*m->model.m[c][0] + m->model.m[c][1]*m->model.m[c][1] +
+                          m->model.m[c][2]*m->model.m[c][2]);
+        scale = fmaxf(scale, len);
+    }
+    vec4_t c = mat4_mul_point(m->model, m->local_center);
+    float r = m->local_radius * scale;
+    box.min.x = fmaxf(box.min.x, c.x - r);
+    box.min.y = fmaxf(box.min.y, c.y - r);
+    box.min.z = fmaxf(box.min.z, c.z - r);
+    box.max.x = fminf(box.max.x, c.x + r);
+    box.max.y = fminf(box.max.y, c.y + r);
+    box.max.z = fminf(box.max.z, c.z + r);
+    m->world_box = box;
+}
+
+void scene_init(scene_t* scene) {
+    memset(scene, 0, sizeof(*scene));
+}
+
+void scene_free(scene_t* scene) {
+    if (!scene) return;
+    free(scene->models);
+    free(scene->nodes);
+    free(scene->order);
+    free(scene->visible);
+    memset(scene, 0, sizeof(*scene));
+}
+
+int scene_add_model(scene_t* scene, vec3_t* vertices, int vertex_count,
+                    int* edges, int edge_count, mat4_t model) {
+    if (!scene || !vertices || vertex_count <= 0 || !edges || edge_count < 0) return -1;
+
+    if (scene->model_count == scene->model_capacity) {
+        int capacity = scene->model_capacity ? scene->model_capacity * 2 : 64;
+        scene_model_t* models = (scene_model_t*)realloc(scene->models, (size_t)capacity * sizeof(scene_model_t));
+        if (!models) return -1;
+        scene->models = models;
+        int* visible = (int*)realloc(scene->visible, (size_t)capacity * sizeof(int));
+        if (!visible) return -1;
+        scene->visible = visible;
+        scene->model_capacity = capacity;
+    }
+
+    scene_model_t* m = &scene->models[scene->model_count];
+    m->vertices = vertices;
+    m->vertex_count = vertex_count;
+    m->edges = edges;
+    m->edge_count = edge_count;
+    m->model = model;
+
+    m->local_box = aabb_empty();
+    for (int i = 0; i < vertex_count; i++) aabb_add_point(&m->local_box, vertices[i]);
+    m->local_center.x = 0.5f * (m->local_box.min.x + m->local_box.max.x);
+    m->local_center.y = 0.5f * (m->local_box.min.y + m->local_box.max.y);
+    m->local_center.z = 0.5f * (m->local_box.min.z + m->local_box.max.z);
+    float r2 = 0.0f;
+    for (int i = 0; i < vertex_count; i++) {
+        vec3_t d = vec3_sub(vertices[i], m->local_center);
+        r2 = fmaxf(r2, vec3_dot(d, d));
+    }
+    m->local_radius = sqrtf(r2) * (1.0f + SCENE_CULL_EPSILON);
+    update_world_box(m);
+
+    scene->needs_build = 1;
+    return scene->model_count++;
+}
+
+void scene_set_transform(scene_t* scene, int id, mat4_t model) {
+    if (!scene || id < 0 || id >= scene->model_count) return;
+    scene->models[id].model = model;
+    update_world_box(&scene->models[id]);
+    scene->needs_refit = 1;
+}
+
+static float box_centroid(const aabb_t* box, int axis) {
+    const float* lo = &box->min.x;
+    const float* hi = &box->max.x;
+    return lo[axis] + hi[axis];
+}
+
+/* Partially sort order[first, last) so the k-th model by centroid is in place */
+static void select_median(const scene_model_t* models, int* order, int first, int last, int k, int axis) {
+    while (last - first > 1) {
+        float pivot = box_centroid(&models[order[first + (last - first) / 2]].world_box, axis);
+        int i = first, j = last - 1;
+        while (i <= j) {
+            while (box_centroid(&models[order[i]].world_box, axis) < pivot) i++;
+            while (box_centroid(&models[order[j]].world_box, axis) > pivot) j--;
+            if (i <= j) {
+                int t = order[i];
+                order[i++] = order[j];
+                order[j--] = t;
+            }
+        }
+        if (k <= j) last = j + 1;
+        else if (k >= i) first = i;
+        else return;
+    }
+}
+
+/* Build the subtree over order[first, first + count); returns its node index */
+static int build_node(scene_t* scene, int first, int count) {
+    int index = scene->node_count++;
+    bvh_node_t* node = &scene->nodes[index];
+    aabb_t box = aabb_empty(), centers = aabb_empty();
+    for (int i = first; i < first + count; i++) {
+        const aabb_t* b = &scene->models[scene->order[i]].world_box;
+        aabb_add_box(&box, b);
+        aabb_add_point(&centers, (vec3_t){b->min.x + b->max.x, b->min.y + b->max.y, b->min.z + b->max.z});
+    }
+    node->box = box;
+    node->first = first;
+    node->count = count;
+    node->left = node->right = -1;
+    if (count <= SCENE_BVH_LEAF_SIZE) return index;
+
+    // Median split along the longest axis of the centroids
+    vec3_t extent = vec3_sub(centers.max, centers.min);
+    int axis = extent.x >= extent.y && extent.x >= extent.z ? 0 : (extent.y >= extent.z ? 1 : 2);
+    int half = count / 2;
+    select_median(scene->models, scene->order, first, first + count, first + half, axis);
+
+    int left = build_node(scene, first, half);
+    int right = build_node(scene, first + half, count - half);
+    scene->nodes[index].left = left;
+    scene->nodes[index].right = right;
+    return index;
+}
+
+/* Recompute every node's box bottom-up, keeping the tree shape */
+static void refit(scene_t* scene) {
+    for (int n = scene->node_count - 1; n >= 0; n--) {
+        bvh_node_t* node = &scene->nodes[n];
+        node->box = aabb_empty();
+        if (node->left < 0) {
+            for (int i = node->first; i < node->first + node->count; i++) {
+                aabb_add_box(&node->box, &scene->models[scene->order[i]].world_box);
+            }
+        } else {
+            aabb_add_box(&node->box, &scene->nodes[node->left].box);
+            aabb_add_box(&node->box, &scene->nodes[node->right].box);
+        }
+    }
+}
+
+int scene_build(scene_t* scene) {
+    if (!scene) return -1;
+
+    if (scene->needs_build && scene->model_count > 0) {
+        int n = scene->model_count;
+        int* order = (int*)realloc(scene->order, (size_t)n * sizeof(int));
+        if (!order) return -1;
+        scene->order = order;
+        bvh_node_t* nodes = (bvh_node_t*)realloc(scene->nodes, (size_t)(2 * n) * sizeof(bvh_node_t));
+        if (!nodes) return -1;
+        scene->nodes = nodes;
+
+        for (int i = 0; i < n; i++) scene->order[i] = i;
+        scene->node_count = 0;
+        build_node(scene, 0, n);
+        scene->needs_build = 0;
+        scene->needs_refit = 0;
+    } else if (scene->needs_refit) {
+        refit(scene);
+        scene->needs_refit = 0;
+    }
+    return 0;
+}
+
+/* Can any part of the box reach a pixel? Tested in clip space, where the
+ * renderer keeps -w <= z <= w, x and y within the canvas widened by the
+ * line's reach, and NDC x^2 + y^2 <= 1 for the circular viewport. */
+static int box_may_be_visible(const mat4_t* view_proj, const aabb_t* box, float kx, float ky) {
+    const float kz = 1.0f + SCENE_CULL_EPSILON;
+    unsigned outside = 0x3f;
+    int in_front = 1;
+    float min_x = INFINITY, min_y = INFINITY, max_x = -INFINITY, max_y = -INFINITY;
+
+    for (int i = 0; i < 8; i++) {
+        vec4_t p = mat4_mul_point(*view_proj, aabb_corner(box, i));
+        unsigned code = 0;
+        if (p.x < -kx * p.w) code |= 1;
+        if (p.x >  kx * p.w) code |= 2;
+        if (p.y < -ky * p.w) code |= 4;
+        if (p.y >  ky * p.w) code |= 8;
+        if (p.z < -kz * p.w) code |= 16;
+        if (p.z >  kz * p.w) code |= 32;
+        outside &= code;
+
+        if (p.w > 0.0f) {
+            float inv = 1.0f / p.w;
+            min_x = fminf(min_x, p.x * inv);
+            max_x = fmaxf(max_x, p.x * inv);
+            min_y = fminf(min_y, p.y * inv);
+            max_y = fmaxf(max_y, p.y * inv);
+        } else {
+            in_front = 0;
+        }
+    }
+    // Every corner beyond the same plane: the whole convex box is
+    if (outside) return 0;
+
+    // With the box in front of the eye its projection lies inside the
+    // rectangle around the projected corners; test that against the circle
+    if (in_front) {
+        float nx = fmaxf(0.0f, fmaxf(min_x, -max_x));
+        float ny = fmaxf(0.0f, fmaxf(min_y, -max_y));
+        if (nx*nx + ny*ny > kz * kz) return 0;
+    }
+    return 1;
+}
+
+static int compare_ids(const void* a, const void* b) {
+    return *(const int*)a - *(const int*)b;
+}
+
+int scene_cull(scene_t* scene, mat4_t view_proj, int width, int height, float thickness, int* visible) {
+    if (!scene || !visible || scene->model_count == 0 || width <= 0 || height <= 0) return 0;
+    if (scene_build(scene) != 0) return 0;
+
+    // Lines reach past the canvas edge by up to half their width plus the fringe
+    float reach = 0.5f * fabsf(thickness) + 0.5f;
+    float kx = (1.0f + 2.0f * reach / (float)width) * (1.0f + SCENE_CULL_EPSILON);
+    float ky = (1.0f + 2.0f * reach / (float)height) * (1.0f + SCENE_CULL_EPSILON);
+
+    int stack[SCENE_BVH_MAX_DEPTH];
+    int top = 0, count = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        const bvh_node_t* node = &scene->nodes[stack[--top]];
+        if (!box_may_be_visible(&view_proj, &node->box, kx, ky)) continue;
+
+        if (node->left < 0) {
+            for (int i = node->first; i < node->first + node->count; i++) {
+                int id = scene->order[i];
+                if (node->count == 1 || box_may_be_visible(&view_proj, &scene->models[id].world_box, kx, ky)) {
+                    visible[count++] = id;
+                }
+            }
+        } else {
+            stack[top++] = node->right;
+            stack[top++] = node->left;
+        }
+    }
+
+    // Draw order must not depend on the tree layout
+    qsort(visible, (size_t)count, sizeof(int), compare_ids);
+    return count;
+}
+
+int scene_render(scene_t* scene, canvas_t* canvas, mat4_t view_proj, float thickness,
+                 const render_options_t* options) {
+    if (!scene || !canvas) return 0;
+
+    // Lighting needs each model's own placement
+    render_options_t model_options = {0};
+    if (options) model_options = *options;
+
+    int count = scene_cull(scene, view_proj, canvas->width, canvas->height, thickness, scene->visible);
+    for (int i = 0; i < count; i++) {
+        const scene_model_t* m = &scene->models[scene->visible[i]];
+        // mat4_mul(a, b) applies a first: object to world, then world to clip
+        mat4_t mvp = mat4_mul(m->model, view_proj);
+        model_options.model = &m->model;
+        render_wireframe_ex(canvas, mvp, m->vertices, m->vertex_count, m->edges, m->edge_count,
+                            thickness, &model_options);
+    }
+    return count;
+}
@@ -0,0 +1,359 @@
+#include "simd.h"
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef TINY3D_X86_SIMD
+#include <immintrin.h>
+#endif
+
+/* Kernel table filled in by the dispatcher */
+typedef struct {
+    void (*fill_f32)(float*, size_t, float);
+    void (*scale_clamp_f32)(float*, const float*, size_t, float);
+    void (*quantize_u8)(uint8_t*, const float*, size_t);
+    void (*quantize_u16)(uint16_t*, const float*, size_t);
+} simd_kernels_t;
+
+/* Scalar kernels (reference results for every vector path) */
+static void fill_f32_scalar(float* dst, size_t count, float value) {
+    for (size_t i = 0; i < count; i++) {
+        dst[i] = value;
+    }
+}
+
+/* NaN fails both tests and maps to 0, as max(v, 0) does in the vector
+ * kernels: their max/min take v first, and x86 returns the second operand
+ * when either is NaN */
+static inline float clamp01(float v) {
+    return v > 0.0f ? (v < 1.0f ? v : 1.0f) : 0.0f;
+}
+
+static void scale_clamp_f32_scalar(float* dst, const float* src, size_t count, float scale) {
+    for (size_t i = 0; i < count; i++) {
+        dst[i] = clamp01(src[i] * scale);
+    }
+}
+
+static void quantize_u8_scalar(uint8_t* dst, const float* src, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        float v = clamp01(src[i]) * 255.0f;
+        dst[i] = (uint8_t)(int)(v + 0.5f);
+    }
+}
+
+static void quantize_u16_scalar(uint16_t* dst, const float* src, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        float v = clamp01(src[i]) * 65535.0f;
+        dst[i] = (uint16_t)(int)(v + 0.5f);
+    }
+}
+
+#ifdef TINY3D_X86_SIMD
+
+/* SSE2 kernels */
+__attribute__((target("sse2")))
+static void fill_f32_sse2(float* dst, size_t count, float value) {
+    __m128 v = _mm_set1_ps(value);
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        _mm_storeu_ps(dst + i, v);
+        _mm_storeu_ps(dst + i + 4, v);
+        _mm_storeu_ps(dst + i + 8, v);
+        _mm_storeu_ps(dst + i + 12, v);
+    }
+    for (; i + 4 <= count; i += 4) _mm_storeu_ps(dst + i, v);
+    fill_f32_scalar(dst + i, count - i, value);
+}
+
+__attribute__((target("sse2")))
+static void scale_clamp_f32_sse2(float* dst, const float* src, size_t count, float scale) {
+    __m128 s = _mm_set1_ps(scale);
+    __m128 lo = _mm_setzero_ps();
+    __m128 hi = _mm_set1_ps(1.0f);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 v = _mm_mul_ps(_mm_loadu_ps(src + i), s);
+        _mm_storeu_ps(dst + i, _mm_min_ps(_mm_max_ps(v, lo), hi));
+    }
+    scale_clamp_f32_scalar(dst + i, src + i, count - i, scale);
+}
+
+__attribute__((target("sse2")))
+static inline __m128i quantize4_sse2(const float* src) {
+    __m128 v = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(src), _mm_setzero_ps()), _mm_set1_ps(1.0f));
+    v = _mm_add_ps(_mm_mul_ps(v, _mm_set1_ps(255.0f)), _mm_set1_ps(0.5f));
+    return _mm_cvttps_epi32(v);
+}
+
+__attribute__((target("sse2")))
+static void quantize_u8_sse2(uint8_t* dst, const float* src, size_t count) {
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m128i a = _mm_packs_epi32(quantize4_sse2(src + i), quantize4_sse2(src + i + 4));
+        __m128i b = _mm_packs_epi32(quantize4_sse2(src + i + 8), quantize4_sse2(src + i + 12));
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_packus_epi16(a, b));
+    }
+    quantize_u8_scalar(dst + i, src + i, count - i);
+}
+
+__attribute__((target("sse2")))
+static inline __m128i quantize4_u16_sse2(const float* src) {
+    __m128 v = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(src), _mm_setzero_ps()), _mm_set1_ps(1.0f));
+    v = _mm_add_ps(_mm_mul_ps(v, _mm_set1_ps(65535.0f)), _mm_set1_ps(0.5f));
+    // No unsigned 32->16 pack before SSE4.1: bias into signed range and back
+    return _mm_sub_epi32(_mm_cvttps_epi32(v), _mm_set1_epi32(32768));
+}
+
+__attribute__((target("sse2")))
+static void quantize_u16_sse2(uint16_t* dst, const float* src, size_t count) {
+    const __m128i bias = _mm_set1_epi16((short)0x8000);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128i packed = _mm_packs_epi32(quantize4_u16_sse2(src + i), quantize4_u16_sse2(src + i + 4));
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_xor_si128(packed, bias));
+    }
+    quantize_u16_scalar(dst + i, src + i, count - i);
+}
+
+/* AVX2 kernels */
+__attribute__((target("avx2")))
+static void fill_f32_avx2(float* dst, size_t count, float value) {
+    __m256 v = _mm256_set1_ps(value);
+    size_t i = 0;
+    for (; i + 32 <= count; i += 32) {
+        _mm256_storeu_ps(dst + i, v);
+        _mm256_storeu_ps(dst + i + 8, v);
+        _mm256_storeu_ps(dst + i + 16, v);
+        _mm256_storeu_ps(dst + i + 24, v);
+    }
+    for (; i + 8 <= count; i += 8) _mm256_storeu_ps(dst + i, v);
+    fill_f32_scalar(dst + i, count - i, value);
+}
+
+__attribute__((target("avx2")))
+static void scale_clamp_f32_avx2(float* dst, const float* src, size_t count, float scale) {
+    __m256 s = _mm256_set1_ps(scale);
+    __m256 lo = _mm256_setzero_ps();
+    __m256 hi = _mm256_set1_ps(1.0f);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 v = _mm256_mul_ps(_mm256_loadu_ps(src + i), s);
+        _mm256_storeu_ps(dst + i, _mm256_min_ps(_mm256_max_ps(v, lo), hi));
+    }
+    scale_clamp_f32_scalar(dst + i, src + i, count - i, scale);
+}
+
+__attribute__((target("avx2")))
+static inline __m256i quantize8_avx2(const float* src) {
+    __m256 v = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(src), _mm256_setzero_ps()), _mm256_set1_ps(1.0f));
+    v = _mm256_add_ps(_mm256_mul_ps(v, _mm256_set1_ps(255.0f)), _mm256_set1_ps(0.5f));
+    return _mm256_cvttps_epi32(v);
+}
+
+__attribute__((target("avx2")))
+static void quantize_u8_avx2(uint8_t* dst, const float* src, size_t count) {
+    // Packs work per 128-bit lane, so the final permute restores element order
+    const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+    size_t i = 0;
+    for (; i + 32 <= count; i += 32) {
+        __m256i a = _mm256_packs_epi32(quantize8_avx2(src + i), quantize8_avx2(src + i + 8));
+        __m256i b = _mm256_packs_epi32(quantize8_avx2(src + i + 16), quantize8_avx2(src + i + 24));
+        __m256i packed = _mm256_permutevar8x32_epi32(_mm256_packus_epi16(a, b), order);
+        _mm256_storeu_si256((__m256i*)(dst + i), packed);
+    }
+    quantize_u8_sse2(dst + i, src + i, count - i);
+}
+
+__attribute__((target("avx2")))
+static void quantize_u16_avx2(uint16_t* dst, const float* src, size_t count) {
+    const __m256 lo = _mm256_setzero_ps();
+    const __m256 hi = _mm256_set1_ps(1.0f);
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m256 a = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(src + i), lo), hi);
+        __m256 b = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(src + i + 8), lo), hi);
+        a = _mm256_add_ps(_mm256_mul_ps(a, _mm256_set1_ps(65535.0f)), _mm256_set1_ps(0.5f));
+        b = _mm256_add_ps(_mm256_mul_ps(b, _mm256_set1_ps(65535.0f)), _mm256_set1_ps(0.5f));
+        __m256i packed = _mm256_packus_epi32(_mm256_cvttps_epi32(a), _mm256_cvttps_epi32(b));
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_permute4x64_epi64(packed, 0xd8));
+    }
+    quantize_u16_sse2(dst + i, src + i, count - i);
+}
+
+/* AVX-512 kernels */
+__attribute__((target("avx512f")))
+static void fill_f32_avx512(float* dst, size_t count, float value) {
+    __m512 v = _mm512_set1_ps(value);
+    size_t i = 0;
+    for (; i + 64 <= count; i += 64) {
+        _mm512_storeu_ps(dst + i, v);
+        _mm512_storeu_ps(dst + i + 16, v);
+        _mm512_storeu_ps(dst + i + 32, v);
+        _mm512_storeu_ps(dst + i + 48, v);
+    }
+    for (; i + 16 <= count; i += 16) _mm512_storeu_ps(dst + i, v);
+    if (i < count) {
+        __mmask16 tail = (__mmask16)((1u << (count - i)) - 1);
+        _mm512_mask_storeu_ps(dst + i, tail, v);
+    }
+}
+
+__attribute__((target("avx512f")))
+static void scale_clamp_f32_avx512(float* dst, const float* src, size_t count, float scale) {
+    __m512 s = _mm512_set1_ps(scale);
+    __m512 lo = _mm512_setzero_ps();
+    __m512 hi = _mm512_set1_ps(1.0f);
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m512 v = _mm512_mul_ps(_mm512_loadu_ps(src + i), s);
+        _mm512_storeu_ps(dst + i, _mm512_min_ps(_mm512_max_ps(v, lo), hi));
+    }
+    scale_clamp_f32_scalar(dst + i, src + i, count - i, scale);
+}
+
+__attribute__((target("avx512f")))
+static void quantize_u8_avx512(uint8_t* dst, const float* src, size_t count) {
+    const __m512 lo = _mm512_setzero_ps();
+    const __m512 hi = _mm512_set1_ps(1.0f);
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m512 v = _mm512_min_ps(_mm512_max_ps(_mm512_loadu_ps(src + i), lo), hi);
+        v = _mm512_add_ps(_mm512_mul_ps(v, _mm512_set1_ps(255.0f)), _mm512_set1_ps(0.5f));
+        _mm_storeu_si128((__m128i*)(dst + i), _mm512_cvtusepi32_epi8(_mm512_cvttps_epi32(v)));
+    }
+    quantize_u8_scalar(dst + i, src + i, count - i);
+}
+
+__attribute__((target("avx512f")))
+static void quantize_u16_avx512(uint16_t* dst, const float* src, size_t count) {
+    const __m512 lo = _mm512_setzero_ps();
+    const __m512 hi = _mm512_set1_ps(1.0f);
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m512 v = _mm512_min_ps(_mm512_max_ps(_mm512_loadu_ps(src + i), lo), hi);
+        v = _mm512_add_ps(_mm512_mul_ps(v, _mm512_set1_ps(65535.0f)), _mm512_set1_ps(0.5f));
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm512_cvtusepi32_epi16(_mm512_cvttps_epi32(v)));
+    }
+    quantize_u16_scalar(dst + i, src + i, count - i);
+}
+
+#endif // TINY3D_X86_SIMD
+
+/* Dispatch state */
+static simd_kernels_t kernels = {
+    fill_f32_scalar, scale_clamp_f32_scalar, quantize_u8_scalar, quantize_u16_scalar
+};
+static tiny3d_isa_t active_isa = TINY3D_ISA_SCALAR;
+static int dispatch_ready = 0;
+
+tiny3d_isa_t simd_detect_isa(void) {
+#ifdef TINY3D_X86_SIMD
+    // Reads CPUID and checks that the OS saves the wider register state
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return TINY3D_ISA_AVX512;
+    if (__builtin_cpu_supports("avx2")) return TINY3D_ISA_AVX2;
+    if (__builtin_cpu_supports("sse2")) return TINY3D_ISA_SSE2;
+#endif
+    return TINY3D_ISA_SCALAR;
+}
+
+static void select_kernels(tiny3d_isa_t isa) {
+    simd_kernels_t k = { fill_f32_scalar, scale_clamp_f32_scalar, quantize_u8_scalar, quantize_u16_scalar };
+#ifdef TINY3D_X86_SIMD
+    switch (isa) {
+    case TINY3D_ISA_AVX512:
+        k.fill_f32 = fill_f32_avx512;
+        k.scale_clamp_f32 = scale_clamp_f32_avx512;
+        k.quantize_u8 = quantize_u8_avx512;
+        k.quantize_u16 = quantize_u16_avx512;
+        break;
+    case TINY3D_ISA_AVX2:
+        k.fill_f32 = fill_f32_avx2;
+        k.scale_clamp_f32 = scale_clamp_f32_avx2;
+        k.quantize_u8 = quantize_u8_avx2;
+        k.quantize_u16 = quantize_u16_avx2;
+        break;
+    case TINY3D_ISA_SSE2:
+        k.fill_f32 = fill_f32_sse2;
+        k.scale_clamp_f32 = scale_clamp_f32_sse2;
+        k.quantize_u8 = quantize_u8_sse2;
+        k.quantize_u16 = quantize_u16_sse2;
+        break;
+    default:
+        break;
+    }
+#endif
+    kernels = k;
+    active_isa = isa;
+}
+
+static tiny3d_isa_t isa_from_name(const char* name, tiny3d_isa_t fallback) {
+    for (int isa = TINY3D_ISA_SCALAR; isa <= TINY3D_ISA_AVX512; isa++) {
+        if (strcmp(name, simd_isa_name((tiny3d_isa_t)isa)) == 0) return (tiny3d_isa_t)isa;
+    }
+    return fallback;
+}
+
+static void simd_init(void) {
+    tiny3d_isa_t isa = simd_detect_isa();
+    const char* forced = getenv("TINY3D_ISA");
+    if (forced) {
+        tiny3d_isa_t requested = isa_from_name(forced, isa);
+        if (requested < isa) isa = requested;
+    }
+    select_kernels(isa);
+    dispatch_ready = 1;
+}
+
+#if defined(__GNUC__) || defined(__clang__)
+/* Pick the ISA at load time so the hot paths never race on first use */
+__attribute__((constructor))
+static void simd_init_at_startup(void) {
+    if (!dispatch_ready) simd_init();
+}
+#endif
+
+static inline const simd_kernels_t* dispatch(void) {
+    if (!dispatch_ready) simd_init();
+    return &kernels;
+}
+
+tiny3d_isa_t simd_active_isa(void) {
+    dispatch();
+    return active_isa;
+}
+
+tiny3d_isa_t simd_force_isa(tiny3d_isa_t isa) {
+    tiny3d_isa_t supported = simd_detect_isa();
+    if (isa > supported) isa = supported;
+    if (isa < TINY3D_ISA_SCALAR) isa = TINY3D_ISA_SCALAR;
+    select_kernels(isa);
+    dispatch_ready = 1;
+    return isa;
+}
+
+const char* simd_isa_name(tiny3d_isa_t isa) {
+    switch (isa) {
+    case TINY3D_ISA_SSE2:   return "sse2";
+    case TINY3D_ISA_AVX2:   return "avx2";
+    case TINY3D_ISA_AVX512: return "avx512";
+    default:                return "scalar";
+    }
+}
+
+/* Public kernels */
+void simd_fill_f32(float* dst, size_t count, float value) {
+    dispatch()->fill_f32(dst, count, value);
+}
+
+void simd_scale_clamp_f32(float* dst, const float* src, size_t count, float scale) {
+    dispatch()->scale_clamp_f32(dst, src, count, scale);
+}
+
+void simd_quantize_u8(uint8_t* dst, const float* src, size_t count) {
+    dispatch()->quantize_u8(dst, src, count);
+}
+
+void simd_quantize_u16(uint16_t* dst, const float* src, size_t count) {
+    dispatch()->quantize_u16(dst, src, count);
+}
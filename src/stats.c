@@ -0,0 +1,180 @@
+#include "stats.h"
+#include <stdio.h>
+#include <string.h>
+
+static const char* stage_names[TINY3D_STAGE_COUNT] = {
+    "transform", "clip", "raster", "lighting", "clear", "present"
+};
+
+const char* tiny3d_stage_name(tiny3d_stage_t stage) {
+    return stage >= 0 && stage < TINY3D_STAGE_COUNT ? stage_names[stage] : "unknown";
+}
+
+#ifdef TINY3D_STATS
+
+#include <stdatomic.h>
+#include <time.h>
+
+/* One span of a stage on one lane, in nanoseconds from the frame start */
+typedef struct {
+    uint64_t start;
+    uint64_t duration;
+    uint8_t stage;
+    uint8_t lane;
+} trace_event_t;
+
+/* Frame being gathered; every field is atomic, since pool workers and other
+ * threads drawing into their own canvases update it concurrently */
+static struct {
+    atomic_uint_fast64_t start;
+    atomic_uint_fast64_t counters[TINY3D_COUNT_TOTAL];
+    atomic_uint_fast64_t stage_ns[TINY3D_STAGE_COUNT];
+    atomic_uint_fast64_t stage_calls[TINY3D_STAGE_COUNT];
+    atomic_int event_count;
+    trace_event_t events[TINY3D_TRACE_EVENTS];
+    atomic_uint_fast64_t canvas_pixels;
+} current;
+
+/* Set between begin_frame and end_frame; the hooks return at once otherwise */
+static atomic_int active;
+
+/* Last ended frame */
+static tiny3d_frame_stats_t last;
+static trace_event_t last_events[TINY3D_TRACE_EVENTS];
+static int last_event_count;
+static uint64_t frames;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+#ifdef _WIN32
+    timespec_get(&ts, TIME_UTC);
+#else
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+#endif
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+void tiny3d_stats_begin_frame(void) {
+    for (int i = 0; i < TINY3D_COUNT_TOTAL; i++) atomic_store(&current.counters[i], 0);
+    for (int s = 0; s < TINY3D_STAGE_COUNT; s++) {
+        atomic_store(&current.stage_ns[s], 0);
+        atomic_store(&current.stage_calls[s], 0);
+    }
+    atomic_store(&current.event_count, 0);
+    atomic_store(&current.canvas_pixels, 0);
+    atomic_store(&current.start, now_ns());
+    atomic_store(&active, 1);
+}
+
+void tiny3d_stats_end_frame(void) {
+    if (!atomic_exchange(&active, 0)) return;  // No frame to end
+    tiny3d_frame_stats_t* f = &last;
+    memset(f, 0, sizeof(*f));
+    f->frame = ++frames;
+    f->frame_ns = now_ns() - atomic_load(&current.start);
+    for (int s = 0; s < TINY3D_STAGE_COUNT; s++) {
+        f->stage_ns[s] = atomic_load(&current.stage_ns[s]);
+        f->stage_calls[s] = atomic_load(&current.stage_calls[s]);
+    }
+    f->vertices_transformed = atomic_load(&current.counters[TINY3D_COUNT_VERTICES]);
+    f->edges_submitted = atomic_load(&current.counters[TINY3D_COUNT_EDGES_SUBMITTED]);
+    f->edges_culled = atomic_load(&current.counters[TINY3D_COUNT_EDGES_CULLED]);
+    f->edges_clipped = atomic_load(&current.counters[TINY3D_COUNT_EDGES_CLIPPED]);
+    f->edges_drawn = atomic_load(&current.counters[TINY3D_COUNT_EDGES_DRAWN]);
+    f->pixels_written = atomic_load(&current.counters[TINY3D_COUNT_PIXELS]);
+    f->canvas_pixels = atomic_load(&current.canvas_pixels);
+    f->overdraw = f->canvas_pixels ? (double)f->pixels_written / (double)f->canvas_pixels : 0.0;
+
+    // Reservations past the end were counted but never stored
+    int count = atomic_load(&current.event_count);
+    if (count > TINY3D_TRACE_EVENTS) {
+        f->trace_dropped = (uint64_t)(count - TINY3D_TRACE_EVENTS);
+        count = TINY3D_TRACE_EVENTS;
+    }
+    memcpy(last_events, current.events, sizeof(trace_event_t) * (size_t)count);
+    last_event_count = count;
+}
+
+tiny3d_frame_stats_t tiny3d_get_frame_stats(void) {
+    return last;
+}
+
+int tiny3d_stats_save_trace(const char* path) {
+    FILE* f = path ? fopen(path, "w") : NULL;
+    if (!f) return -1;
+
+    // Complete ("X") events with microsecond timestamps, one thread row per lane
+    fprintf(f, "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [\n");
+    fprintf(f, "  {\"name\": \"frame\", \"ph\": \"X\", \"pid\": 1, \"tid\": 0, \"ts\": 0.000, "
+               "\"dur\": %.3f, \"args\": {\"frame\": %llu}}",
+            last.frame_ns / 1e3, (unsigned long long)last.frame);
+    for (int i = 0; i < last_event_count; i++) {
+        const trace_event_t* e = &last_events[i];
+        fprintf(f, ",\n  {\"name\": \"%s\", \"ph\": \"X\", \"pid\": 1, \"tid\": %d, \"ts\": %.3f, \"dur\": %.3f}",
+                stage_names[e->stage], e->lane, e->start / 1e3, e->duration / 1e3);
+    }
+    fprintf(f, "\n]}\n");
+    return fclose(f) == 0 ? 0 : -1;
+}
+
+static int frame_active(void) {
+    return atomic_load_explicit(&active, memory_order_relaxed);
+}
+
+/* 0 marks a span begun outside a frame, which stats_stage_end drops */
+uint64_t stats_stage_begin(void) {
+    return frame_active() ? now_ns() : 0;
+}
+
+void stats_stage_end(tiny3d_stage_t stage, uint64_t start, int lane) {
+    if (!start || !frame_active()) return;
+    uint64_t end = now_ns();
+    // Worker lanes only add trace events, so stage times stay the caller's wall time
+    if (lane == 0) {
+        atomic_fetch_add_explicit(&current.stage_ns[stage], end - start, memory_order_relaxed);
+        atomic_fetch_add_explicit(&current.stage_calls[stage], 1, memory_order_relaxed);
+    }
+
+    int slot = atomic_fetch_add_explicit(&current.event_count, 1, memory_order_relaxed);
+    if (slot >= TINY3D_TRACE_EVENTS) return;
+    trace_event_t* e = &current.events[slot];
+    uint64_t frame_start = atomic_load_explicit(&current.start, memory_order_relaxed);
+    e->start = start > frame_start ? start - frame_start : 0;
+    e->duration = end - start;
+    e->stage = (uint8_t)stage;
+    e->lane = (uint8_t)(lane < 255 ? lane : 255);
+}
+
+void stats_count(tiny3d_counter_t counter, uint64_t n) {
+    if (!frame_active()) return;
+    atomic_fetch_add_explicit(&current.counters[counter], n, memory_order_relaxed);
+}
+
+void stats_canvas(int width, int height) {
+    if (!frame_active()) return;
+    uint64_t area = (uint64_t)width * (uint64_t)height;
+    // Atomic max: retry until the stored value is at least this area
+    uint_fast64_t seen = atomic_load_explicit(&current.canvas_pixels, memory_order_relaxed);
+    while (area > seen &&
+           !atomic_compare_exchange_weak_explicit(&current.canvas_pixels, &seen, area,
+                                                  memory_order_relaxed, memory_order_relaxed)) {
+    }
+}
+
+#else // TINY3D_STATS
+
+void tiny3d_stats_begin_frame(void) {}
+void tiny3d_stats_end_frame(void) {}
+
+tiny3d_frame_stats_t tiny3d_get_frame_stats(void) {
+    tiny3d_frame_stats_t f;
+    memset(&f, 0, sizeof(f));
+    return f;
+}
+
+int tiny3d_stats_save_trace(const char* path) {
+    (void)path;
+    return -1;
+}
+
+#endif // TINY3D_STATS
@@ -0,0 +1,182 @@
+#include "threadpool.h"
+#include <stdlib.h>
+
+#if !defined(TINY3D_NO_THREADS) && !defined(_WIN32)
+#define TINY3D_PTHREADS 1
+#include <pthread.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#endif
+
+#ifdef TINY3D_PTHREADS
+
+struct thread_pool {
+    int thread_count;          // Workers plus the calling thread
+    pthread_t* threads;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;       // Signalled when a new job is posted
+    pthread_cond_t done;       // Signalled when the last worker finishes a job
+    unsigned generation;       // Incremented for every job
+    int busy_workers;
+    int shutdown;
+
+    // Current job
+    thread_task_fn fn;
+    void* ctx;
+    int task_count;
+    atomic_int next_task;
+};
+
+typedef struct {
+    thread_pool_t* pool;
+    int worker;
+} worker_arg_t;
+
+static void run_tasks(thread_pool_t* pool, int worker) {
+    int task;
+    while ((task = atomic_fetch_add(&pool->next_task, 1)) < pool->task_count) {
+        pool->fn(pool->ctx, task, worker);
+    }
+}
+
+static void* worker_main(void* arg) {
+    worker_arg_t* wa = (worker_arg_t*)arg;
+    thread_pool_t* pool = wa->pool;
+    int worker = wa->worker;
+    free(wa);
+
+    unsigned seen = 0;
+    for (;;) {
+        pthread_mutex_lock(&pool->lock);
+        while (pool->generation == seen && !pool->shutdown) {
+            pthread_cond_wait(&pool->wake, &pool->lock);
+        }
+        if (pool->shutdown) {
+            pthread_mutex_unlock(&pool->lock);
+            return NULL;
+        }
+        seen = pool->generation;
+        pthread_mutex_unlock(&pool->lock);
+
+        run_tasks(pool, worker);
+
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->busy_workers == 0) pthread_cond_signal(&pool->done);
+        pthread_mutex_unlock(&pool->lock);
+    }
+}
+
+thread_pool_t* thread_pool_create(int thread_count) {
+    if (thread_count <= 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        thread_count = cpus > 0 ? (int)cpus : 1;
+    }
+
+    thread_pool_t* pool = (thread_pool_t*)calloc(1, sizeof(thread_pool_t));
+    if (!pool) return NULL;
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->wake, NULL);
+    pthread_cond_init(&pool->done, NULL);
+    atomic_init(&pool->next_task, 0);
+    pool->thread_count = 1;
+
+    // The calling thread is worker 0, so only thread_count - 1 are spawned
+    pool->threads = (pthread_t*)malloc((size_t)thread_count * sizeof(pthread_t));
+    if (!pool->threads) {
+        thread_pool_destroy(pool);
+        return NULL;
+    }
+    for (int i = 1; i < thread_count; i++) {
+        worker_arg_t* wa = (worker_arg_t*)malloc(sizeof(worker_arg_t));
+        if (!wa) break;
+        wa->pool = pool;
+        wa->worker = i;
+        if (pthread_create(&pool->threads[i], NULL, worker_main, wa) != 0) {
+            free(wa);
+            break;
+        }
+        pool->thread_count++;
+    }
+
+    return pool;
+}
+
+void thread_pool_destroy(thread_pool_t* pool) {
+    if (!pool) return;
+
+    pthread_mutex_lock(&pool->lock);
+    pool->shutdown = 1;
+    pthread_cond_broadcast(&pool->wake);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (int i = 1; i < pool->thread_count; i++) {
+        pthread_join(pool->threads[i], NULL);
+    }
+
+    pthread_cond_destroy(&pool->done);
+    pthread_cond_destroy(&pool->wake);
+    pthread_mutex_destroy(&pool->lock);
+    free(pool->threads);
+    free(pool);
+}
+
+int thread_pool_size(const thread_pool_t* pool) {
+    return pool ? pool->thread_count : 1;
+}
+
+void thread_pool_run(thread_pool_t* pool, int task_count, thread_task_fn fn, void* ctx) {
+    if (task_count <= 0) return;
+
+    // Small jobs and single-threaded pools skip the hand-off entirely
+    if (!pool || pool->thread_count == 1 || task_count == 1) {
+        for (int i = 0; i < task_count; i++) fn(ctx, i, 0);
+        return;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    pool->fn = fn;
+    pool->ctx = ctx;
+    pool->task_count = task_count;
+    atomic_store(&pool->next_task, 0);
+    pool->busy_workers = pool->thread_count - 1;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->wake);
+    pthread_mutex_unlock(&pool->lock);
+
+    run_tasks(pool, 0);
+
+    pthread_mutex_lock(&pool->lock);
+    while (pool->busy_workers > 0) {
+        pthread_cond_wait(&pool->done, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+}
+
+#else // Inline fallback
+
+struct thread_pool {
+    int thread_count;
+};
+
+thread_pool_t* thread_pool_create(int thread_count) {
+    (void)thread_count;
+    thread_pool_t* pool = (thread_pool_t*)malloc(sizeof(thread_pool_t));
+    if (pool) pool->thread_count = 1;
+    return pool;
+}
+
+void thread_pool_destroy(thread_pool_t* pool) {
+    free(pool);
+}
+
+int thread_pool_size(const thread_pool_t* pool) {
+    (void)pool;
+    return 1;
+}
+
+void thread_pool_run(thread_pool_t* pool, int task_count, thread_task_fn fn, void* ctx) {
+    (void)pool;
+    for (int i = 0; i < task_count; i++) fn(ctx, i, 0);
+}
+
+#endif // TINY3D_PTHREADS
@@ -0,0 +1,137 @@
+#include "transform.h"
+#include "simd.h"
+
+#ifdef TINY3D_X86_SIMD
+#include <immintrin.h>
+#endif
+
+/* Keep multiply and add separate so every ISA rounds identically */
+#if defined(__clang__)
+#pragma STDC FP_CONTRACT OFF
+#elif defined(__GNUC__)
+#pragma GCC optimize("fp-contract=off")
+#endif
+
+/* Row r of the column-major matrix, spread so it can be broadcast */
+typedef struct {
+    float r[4][4];  // [row][column]
+} mat4_rows_t;
+
+static void mat4_rows(const mat4_t* m, mat4_rows_t* out) {
+    for (int row = 0; row < 4; row++) {
+        for (int col = 0; col < 4; col++) {
+            out->r[row][col] = m->m[col][row];
+        }
+    }
+}
+
+/* Scalar kernel; the vector kernels repeat its exact operation order */
+static void transform_scalar(const mat4_rows_t* m, const float* x, const float* y, const float* z,
+                             int begin, int end, float hw, float hh,
+                             float* out_x, float* out_y, float* out_depth, float* out_w) {
+    for (int i = begin; i < end; i++) {
+        float cx = m->r[0][0]*x[i] + m->r[0][1]*y[i] + m->r[0][2]*z[i] + m->r[0][3];
+        float cy = m->r[1][0]*x[i] + m->r[1][1]*y[i] + m->r[1][2]*z[i] + m->r[1][3];
+        float cz = m->r[2][0]*x[i] + m->r[2][1]*y[i] + m->r[2][2]*z[i] + m->r[2][3];
+        float cw = m->r[3][0]*x[i] + m->r[3][1]*y[i] + m->r[3][2]*z[i] + m->r[3][3];
+
+        float inv = 1.0f / (cw != 0.0f ? cw : 1.0f);
+        out_x[i] = cx * inv * hw + hw;
+        out_y[i] = hh - cy * inv * hh;
+        if (out_depth) out_depth[i] = cz * inv;
+        if (out_w) out_w[i] = cw;
+    }
+}
+
+#ifdef TINY3D_X86_SIMD
+
+/* One lane block per ISA: V is the vector type, P the intrinsic prefix */
+#define DEFINE_TRANSFORM_KERNEL(NAME, TARGET, WIDTH, V, P, SELECT)                        \
+__attribute__((target(TARGET)))                                                           \
+static int NAME(const mat4_rows_t* m, const float* x, const float* y, const float* z,    \
+                int count, float hw, float hh,                                            \
+                float* out_x, float* out_y, float* out_depth, float* out_w) {             \
+    V r[4][4];                                                                            \
+    for (int a = 0; a < 4; a++)                                                           \
+        for (int b = 0; b < 4; b++) r[a][b] = P##_set1_ps(m->r[a][b]);                    \
+    const V one = P##_set1_ps(1.0f), zero = P##_setzero_ps();                            \
+    const V vhw = P##_set1_ps(hw), vhh = P##_set1_ps(hh);                                 \
+    int i = 0;                                                                            \
+    for (; i + WIDTH <= count; i += WIDTH) {                                              \
+        V vx = P##_loadu_ps(x + i), vy = P##_loadu_ps(y + i), vz = P##_loadu_ps(z + i);   \
+        V c[4];                                                                           \
+        for (int a = 0; a < 4; a++) {                                                     \
+            c[a] = P##_add_ps(P##_add_ps(P##_add_ps(P##_mul_ps(r[a][0], vx),              \
+                                                    P##_mul_ps(r[a][1], vy)),             \
+                                         P##_mul_ps(r[a][2], vz)), r[a][3]);              \
+        }                                                                                 \
+        V inv = P##_div_ps(one, SELECT(c[3], zero, one));                                 \
+        P##_storeu_ps(out_x + i, P##_add_ps(P##_mul_ps(P##_mul_ps(c[0], inv), vhw), vhw)); \
+        P##_storeu_ps(out_y + i, P##_sub_ps(vhh, P##_mul_ps(P##_mul_ps(c[1], inv), vhh))); \
+        if (out_depth) P##_storeu_ps(out_depth + i, P##_mul_ps(c[2], inv));               \
+        if (out_w) P##_storeu_ps(out_w + i, c[3]);                                        \
+    }                                                                                     \
+    return i;                                                                             \
+}
+
+/* w != 0 ? w : 1 */
+#define SELECT_SSE2(w, zero, one) \
+    _mm_or_ps(_mm_and_ps(_mm_cmpneq_ps(w, zero), w), _mm_andnot_ps(_mm_cmpneq_ps(w, zero), one))
+#define SELECT_AVX2(w, zero, one) \
+    _mm256_blendv_ps(one, w, _mm256_cmp_ps(w, zero, _CMP_NEQ_UQ))
+#define SELECT_AVX512(w, zero, one) \
+    _mm512_mask_blend_ps(_mm512_cmp_ps_mask(w, zero, _CMP_NEQ_UQ), one, w)
+
+DEFINE_TRANSFORM_KERNEL(transform_sse2, "sse2", 4, __m128, _mm, SELECT_SSE2)
+DEFINE_TRANSFORM_KERNEL(transform_avx2, "avx2", 8, __m256, _mm256, SELECT_AVX2)
+DEFINE_TRANSFORM_KERNEL(transform_avx512, "avx512f", 16, __m512, _mm512, SELECT_AVX512)
+
+#endif // TINY3D_X86_SIMD
+
+void transform_points_soa(
+    const mat4_t* mvp,
+    const float* x,
+    const float* y,
+    const float* z,
+    int count,
+    float viewport_w,
+    float viewport_h,
+    float* out_x,
+    float* out_y,
+    float* out_depth,
+    float* out_w
+) {
+    if (count <= 0) return;
+
+    mat4_rows_t m;
+    mat4_rows(mvp, &m);
+    float hw = 0.5f * viewport_w;
+    float hh = 0.5f * viewport_h;
+    int done = 0;
+
+#ifdef TINY3D_X86_SIMD
+    switch (simd_active_isa()) {
+    case TINY3D_ISA_AVX512:
+        done = transform_avx512(&m, x, y, z, count, hw, hh, out_x, out_y, out_depth, out_w);
+        break;
+    case TINY3D_ISA_AVX2:
+        done = transform_avx2(&m, x, y, z, count, hw, hh, out_x, out_y, out_depth, out_w);
+        break;
+    case TINY3D_ISA_SSE2:
+        done = transform_sse2(&m, x, y, z, count, hw, hh, out_x, out_y, out_depth, out_w);
+        break;
+    default:
+        break;
+    }
+#endif
+
+    transform_scalar(&m, x, y, z, done, count, hw, hh, out_x, out_y, out_depth, out_w);
+}
+
+void vec3_to_soa(const vec3_t* v, int count, float* x, float* y, float* z) {
+    for (int i = 0; i < count; i++) {
+        x[i] = v[i].x;
+        y[i] = v[i].y;
+        z[i] = v[i].z;
+    }
+}
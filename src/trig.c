@@ -0,0 +1,391 @@
+#include "trig.h"
+#include "simd.h"
+#include <math.h>
+#include <string.h>
+
+#ifdef TINY3D_X86_SIMD
+#include <immintrin.h>
+#endif
+
+/* Keep multiply and add separate so every ISA rounds identically */
+#if defined(__clang__)
+#pragma STDC FP_CONTRACT OFF
+#elif defined(__GNUC__)
+#pragma GCC optimize("fp-contract=off")
+#endif
+
+#define TRIG_PI 3.14159265358979f
+#define TRIG_PIO2 1.57079632679490f
+#define TRIG_PIO4 0.785398163397448f
+#define TRIG_TAN_PIO8 0.414213562373095f
+#define TRIG_TWO_OVER_PI 0.636619772367581f
+
+/* Adding and removing 1.5 * 2^23 rounds to the nearest integer */
+#define TRIG_ROUND_MAGIC 12582912.0f
+
+/* Largest |x| the three-part reduction below handles; beyond it, and for
+ * inf and NaN, sincos falls back to sinf/cosf */
+#define TRIG_REDUCE_LIMIT 8192.0f
+
+/* pi/2 in three parts (Cody-Waite); q * PIO2_1 is exact for |q| < 2^16 */
+#define PIO2_1 1.5703125f
+#define PIO2_2 4.837512969970703125e-4f
+#define PIO2_3 7.54978995489188216e-8f
+
+/* sin(r) = r + r*z*S(z) and cos(r) = 1 - z/2 + z*z*C(z) on [-pi/4, pi/4] (Cephes) */
+#define SIN_1 -1.6666654611e-1f
+#define SIN_2 8.3321608736e-3f
+#define SIN_3 -1.9515295891e-4f
+#define COS_1 4.166664568298827e-2f
+#define COS_2 -1.388731625493765e-3f
+#define COS_3 2.443315711809948e-5f
+
+/* Fast: sin(r) = r + r*z*(a + b*z), cos(r) = 1 + z*(c + d*z), near-minimax fits */
+#define SIN_FAST_1 -1.6662834e-1f
+#define SIN_FAST_2 8.1529909e-3f
+#define COS_FAST_1 -4.9977631e-1f
+#define COS_FAST_2 4.0488940e-2f
+
+/* asin(s) = s + s*z*A(z), z = s*s, s in [0, 1/2] (Cephes) */
+#define ASIN_1 1.6666752422e-1f
+#define ASIN_2 7.4953002686e-2f
+#define ASIN_3 4.5470025998e-2f
+#define ASIN_4 2.4181311049e-2f
+#define ASIN_5 4.2163199048e-2f
+#define ASIN_FAST_1 1.6470951e-1f
+#define ASIN_FAST_2 9.5892014e-2f
+
+/* atan(t) = t + t*z*T(z), z = t*t, |t| <= tan(pi/8) (Cephes) */
+#define ATAN_1 -3.33329491539e-1f
+#define ATAN_2 1.99777106478e-1f
+#define ATAN_3 -1.38776856032e-1f
+#define ATAN_4 8.05374449538e-2f
+#define ATAN_FAST_1 -3.3156819e-1f
+#define ATAN_FAST_2 1.6856612e-1f
+
+/* libm for the values outside the reduction range, shared by every kernel so
+ * they stay identical there too */
+static void sincos_out_of_range(const float* x, float* s_out, float* c_out, int count) {
+    for (int i = 0; i < count; i++) {
+        float xi = x[i];
+        if (fabsf(xi) < TRIG_REDUCE_LIMIT) continue;  // Also false for NaN
+        if (s_out) s_out[i] = sinf(xi);
+        if (c_out) c_out[i] = cosf(xi);
+    }
+}
+
+/* Scalar kernels; the vector kernels repeat their exact operation order */
+static void sincos_scalar(const float* x, float* s_out, float* c_out, int begin, int end, int fast) {
+    for (int i = begin; i < end; i++) {
+        // Out of range q would overflow the int conversion
+        if (!(fabsf(x[i]) < TRIG_REDUCE_LIMIT)) {
+            sincos_out_of_range(x + i, s_out ? s_out + i : NULL, c_out ? c_out + i : NULL, 1);
+            continue;
+        }
+        float fq = (x[i] * TRIG_TWO_OVER_PI + TRIG_ROUND_MAGIC) - TRIG_ROUND_MAGIC;
+        int q = (int)fq;
+        float r = ((x[i] - fq * PIO2_1) - fq * PIO2_2) - fq * PIO2_3;
+        float z = r * r;
+        float s, c;
+        if (fast) {
+            s = r + r * z * (SIN_FAST_1 + z * SIN_FAST_2);
+            c = 1.0f + z * (COS_FAST_1 + z * COS_FAST_2);
+        } else {
+            s = r + r * z * (SIN_1 + z * (SIN_2 + z * SIN_3));
+            c = 1.0f - 0.5f * z + z * z * (COS_1 + z * (COS_2 + z * COS_3));
+        }
+
+        // Quadrant: odd ones swap sin and cos, then each gets its sign
+        if (q & 1) { float t = s; s = c; c = t; }
+        if (q & 2) s = -s;
+        if ((q + 1) & 2) c = -c;
+        if (s_out) s_out[i] = s;
+        if (c_out) c_out[i] = c;
+    }
+}
+
+static void acos_scalar(const float* x, float* out, int begin, int end, int fast) {
+    for (int i = begin; i < end; i++) {
+        float ax = fabsf(x[i]);
+        int big = 0.5f < ax;
+        // Near +-1, acos(x) = 2 asin(sqrt((1 - |x|) / 2)) keeps the argument small
+        float z = big ? (1.0f - ax) * 0.5f : x[i] * x[i];
+        float s = big ? sqrtf(z) : ax;
+        float p = fast ? s + s * z * (ASIN_FAST_1 + z * ASIN_FAST_2)
+                       : s + s * z * (ASIN_1 + z * (ASIN_2 + z * (ASIN_3 + z * (ASIN_4 + z * ASIN_5))));
+        float two_p = p + p;
+        float big_r = x[i] < 0.0f ? TRIG_PI - two_p : two_p;
+        float small_r = TRIG_PIO2 - copysignf(p, x[i]);
+        out[i] = big ? big_r : small_r;
+    }
+}
+
+static void atan2_scalar(const float* y, const float* x, float* out, int begin, int end, int fast) {
+    for (int i = begin; i < end; i++) {
+        float ax = fabsf(x[i]), ay = fabsf(y[i]);
+        float hi = ax > ay ? ax : ay;
+        float lo = ax < ay ? ax : ay;
+        float a = 0.0f < hi ? lo / hi : 0.0f;
+
+        // atan(a) = pi/4 + atan((a - 1) / (a + 1)) above tan(pi/8)
+        int reduce = TRIG_TAN_PIO8 < a;
+        float t = reduce ? (a - 1.0f) / (a + 1.0f) : a;
+        float z = t * t;
+        float r = fast ? t + t * z * (ATAN_FAST_1 + z * ATAN_FAST_2)
+                       : t + t * z * (ATAN_1 + z * (ATAN_2 + z * (ATAN_3 + z * ATAN_4)));
+        r = reduce ? r + TRIG_PIO4 : r;
+        r = ax < ay ? TRIG_PIO2 - r : r;
+        r = x[i] < 0.0f ? TRIG_PI - r : r;
+        out[i] = copysignf(r, y[i]);
+    }
+}
+
+#ifdef TINY3D_X86_SIMD
+
+/* Lane blocks per ISA: V/VI are the float and integer vector types, P the
+ * intrinsic prefix, SI the integer suffix, LT a compare giving an integer
+ * lane mask and ALL a test that every lane of such a mask is set. Selects
+ * and sign changes are integer bit operations, which every ISA here has. */
+#define T_CAST(P, SI, v) P##_castps_##SI(v)
+#define T_FLOAT(P, SI, v) P##_cast##SI##_ps(v)
+#define T_SEL(P, SI, m, a, b) /* m ? a : b */                                             \
+    T_FLOAT(P, SI, P##_xor_##SI(T_CAST(P, SI, b),                                        \
+                                P##_and_##SI(P##_xor_##SI(T_CAST(P, SI, a), T_CAST(P, SI, b)), m)))
+#define T_XOR(P, SI, v, bits) T_FLOAT(P, SI, P##_xor_##SI(T_CAST(P, SI, v), bits))
+#define T_AND(P, SI, v, bits) T_FLOAT(P, SI, P##_and_##SI(T_CAST(P, SI, v), bits))
+
+#define DEFINE_TRIG_KERNELS(SUFFIX, TARGET, WIDTH, V, VI, P, SI, LT, ALL)                  \
+__attribute__((target(TARGET)))                                                           \
+static int sincos_##SUFFIX(const float* x, float* s_out, float* c_out, int count, int fast) { \
+    const V magic = P##_set1_ps(TRIG_ROUND_MAGIC), k = P##_set1_ps(TRIG_TWO_OVER_PI);      \
+    const V limit = P##_set1_ps(TRIG_REDUCE_LIMIT), neg_limit = P##_set1_ps(-TRIG_REDUCE_LIMIT); \
+    const VI one_i = P##_set1_epi32(1), two_i = P##_set1_epi32(2), zero_i = P##_setzero_##SI(); \
+    const VI abs_i = P##_set1_epi32(0x7fffffff);                                          \
+    int i = 0;                                                                            \
+    for (; i + WIDTH <= count; i += WIDTH) {                                              \
+        V vx = P##_loadu_ps(x + i);                                                       \
+        /* Out of range lanes are redone with libm; clamping keeps their q an int */      \
+        int in_range = ALL(LT(T_AND(P, SI, vx, abs_i), limit));                           \
+        float lanes[WIDTH];                                                               \
+        if (!in_range) P##_storeu_ps(lanes, vx);                                          \
+        vx = P##_min_ps(P##_max_ps(vx, neg_limit), limit);                                \
+        V fq = P##_sub_ps(P##_add_ps(P##_mul_ps(vx, k), magic), magic);                   \
+        VI q = P##_cvttps_epi32(fq);                                                      \
+        V r = P##_sub_ps(P##_sub_ps(P##_sub_ps(vx, P##_mul_ps(fq, P##_set1_ps(PIO2_1))),  \
+                                    P##_mul_ps(fq, P##_set1_ps(PIO2_2))),                 \
+                         P##_mul_ps(fq, P##_set1_ps(PIO2_3)));                            \
+        V z = P##_mul_ps(r, r);                                                           \
+        V s, c;                                                                           \
+        if (fast) {                                                                       \
+            s = P##_add_ps(r, P##_mul_ps(P##_mul_ps(r, z),                                \
+                    P##_add_ps(P##_set1_ps(SIN_FAST_1), P##_mul_ps(z, P##_set1_ps(SIN_FAST_2))))); \
+            c = P##_add_ps(P##_set1_ps(1.0f), P##_mul_ps(z,                               \
+                    P##_add_ps(P##_set1_ps(COS_FAST_1), P##_mul_ps(z, P##_set1_ps(COS_FAST_2))))); \
+        } else {                                                                          \
+            V ps = P##_add_ps(P##_set1_ps(SIN_2), P##_mul_ps(z, P##_set1_ps(SIN_3)));     \
+            ps = P##_add_ps(P##_set1_ps(SIN_1), P##_mul_ps(z, ps));                       \
+            s = P##_add_ps(r, P##_mul_ps(P##_mul_ps(r, z), ps));                          \
+            V pc = P##_add_ps(P##_set1_ps(COS_2), P##_mul_ps(z, P##_set1_ps(COS_3)));     \
+            pc = P##_add_ps(P##_set1_ps(COS_1), P##_mul_ps(z, pc));                       \
+            c = P##_add_ps(P##_sub_ps(P##_set1_ps(1.0f), P##_mul_ps(P##_set1_ps(0.5f), z)), \
+                           P##_mul_ps(P##_mul_ps(z, z), pc));                             \
+        }                                                                                 \
+        VI swap = P##_sub_epi32(zero_i, P##_and_##SI(q, one_i));                          \
+        V s2 = T_SEL(P, SI, swap, c, s), c2 = T_SEL(P, SI, swap, s, c);                   \
+        s2 = T_XOR(P, SI, s2, P##_slli_epi32(P##_and_##SI(q, two_i), 30));                \
+        c2 = T_XOR(P, SI, c2, P##_slli_epi32(P##_and_##SI(P##_add_epi32(q, one_i), two_i), 30)); \
+        if (s_out) P##_storeu_ps(s_out + i, s2);                                          \
+        if (c_out) P##_storeu_ps(c_out + i, c2);                                          \
+        if (!in_range) sincos_out_of_range(lanes, s_out ? s_out + i : NULL,               \
+                                           c_out ? c_out + i : NULL, WIDTH);              \
+    }                                                                                     \
+    return i;                                                                             \
+}                                                                                         \
+                                                                                          \
+__attribute__((target(TARGET)))                                                           \
+static int acos_##SUFFIX(const float* x, float* out, int count, int fast) {              \
+    const VI abs_i = P##_set1_epi32(0x7fffffff), sign_i = P##_set1_epi32((int)0x80000000u); \
+    const V half = P##_set1_ps(0.5f), one = P##_set1_ps(1.0f), zero = P##_setzero_ps();   \
+    int i = 0;                                                                            \
+    for (; i + WIDTH <= count; i += WIDTH) {                                              \
+        V vx = P##_loadu_ps(x + i);                                                       \
+        V ax = T_AND(P, SI, vx, abs_i);                                                   \
+        VI big = LT(half, ax);                                                            \
+        V z = T_SEL(P, SI, big, P##_mul_ps(P##_sub_ps(one, ax), half), P##_mul_ps(vx, vx)); \
+        V s = T_SEL(P, SI, big, P##_sqrt_ps(z), ax);                                      \
+        V poly;                                                                           \
+        if (fast) {                                                                       \
+            poly = P##_add_ps(P##_set1_ps(ASIN_FAST_1), P##_mul_ps(z, P##_set1_ps(ASIN_FAST_2))); \
+        } else {                                                                          \
+            poly = P##_add_ps(P##_set1_ps(ASIN_4), P##_mul_ps(z, P##_set1_ps(ASIN_5)));   \
+            poly = P##_add_ps(P##_set1_ps(ASIN_3), P##_mul_ps(z, poly));                  \
+            poly = P##_add_ps(P##_set1_ps(ASIN_2), P##_mul_ps(z, poly));                  \
+            poly = P##_add_ps(P##_set1_ps(ASIN_1), P##_mul_ps(z, poly));                  \
+        }                                                                                 \
+        V p = P##_add_ps(s, P##_mul_ps(P##_mul_ps(s, z), poly));                          \
+        V two_p = P##_add_ps(p, p);                                                       \
+        V big_r = T_SEL(P, SI, LT(vx, zero), P##_sub_ps(P##_set1_ps(TRIG_PI), two_p), two_p); \
+        V signed_p = T_XOR(P, SI, p, P##_and_##SI(T_CAST(P, SI, vx), sign_i));            \
+        V small_r = P##_sub_ps(P##_set1_ps(TRIG_PIO2), signed_p);                         \
+        P##_storeu_ps(out + i, T_SEL(P, SI, big, big_r, small_r));                        \
+    }                                                                                     \
+    return i;                                                                             \
+}                                                                                         \
+                                                                                          \
+__attribute__((target(TARGET)))                                                           \
+static int atan2_##SUFFIX(const float* y, const float* x, float* out, int count, int fast) { \
+    const VI abs_i = P##_set1_epi32(0x7fffffff), sign_i = P##_set1_epi32((int)0x80000000u); \
+    const V one = P##_set1_ps(1.0f), zero = P##_setzero_ps();                             \
+    int i = 0;                                                                            \
+    for (; i + WIDTH <= count; i += WIDTH) {                                              \
+        V vx = P##_loadu_ps(x + i), vy = P##_loadu_ps(y + i);                             \
+        V ax = T_AND(P, SI, vx, abs_i), ay = T_AND(P, SI, vy, abs_i);                     \
+        V hi = P##_max_ps(ax, ay), lo = P##_min_ps(ax, ay);                               \
+        V a = T_SEL(P, SI, LT(zero, hi), P##_div_ps(lo, hi), zero);                       \
+        VI reduce = LT(P##_set1_ps(TRIG_TAN_PIO8), a);                                    \
+        V t = T_SEL(P, SI, reduce, P##_div_ps(P##_sub_ps(a, one), P##_add_ps(a, one)), a); \
+        V z = P##_mul_ps(t, t);                                                           \
+        V poly;                                                                           \
+        if (fast) {                                                                       \
+            poly = P##_add_ps(P##_set1_ps(ATAN_FAST_1), P##_mul_ps(z, P##_set1_ps(ATAN_FAST_2))); \
+        } else {                                                                          \
+            poly = P##_add_ps(P##_set1_ps(ATAN_3), P##_mul_ps(z, P##_set1_ps(ATAN_4)));   \
+            poly = P##_add_ps(P##_set1_ps(ATAN_2), P##_mul_ps(z, poly));                  \
+            poly = P##_add_ps(P##_set1_ps(ATAN_1), P##_mul_ps(z, poly));                  \
+        }                                                                                 \
+        V r = P##_add_ps(t, P##_mul_ps(P##_mul_ps(t, z), poly));                          \
+        r = T_SEL(P, SI, reduce, P##_add_ps(r, P##_set1_ps(TRIG_PIO4)), r);               \
+        r = T_SEL(P, SI, LT(ax, ay), P##_sub_ps(P##_set1_ps(TRIG_PIO2), r), r);           \
+        r = T_SEL(P, SI, LT(vx, zero), P##_sub_ps(P##_set1_ps(TRIG_PI), r), r);           \
+        r = T_XOR(P, SI, r, P##_and_##SI(T_CAST(P, SI, vy), sign_i));                     \
+        P##_storeu_ps(out + i, r);                                                        \
+    }                                                                                     \
+    return i;                                                                             \
+}
+
+/* a < b as an all-ones integer lane mask */
+#define LT_SSE2(a, b) _mm_castps_si128(_mm_cmplt_ps(a, b))
+#define LT_AVX2(a, b) _mm256_castps_si256(_mm256_cmp_ps(a, b, _CMP_LT_OQ))
+#define LT_AVX512(a, b) _mm512_maskz_mov_epi32(_mm512_cmp_ps_mask(a, b, _CMP_LT_OQ), _mm512_set1_epi32(-1))
+
+/* Every lane of an integer mask set */
+#define ALL_SSE2(m) (_mm_movemask_epi8(m) == 0xffff)
+#define ALL_AVX2(m) (_mm256_movemask_epi8(m) == -1)
+#define ALL_AVX512(m) (_mm512_test_epi32_mask(m, m) == 0xffff)
+
+DEFINE_TRIG_KERNELS(sse2, "sse2", 4, __m128, __m128i, _mm, si128, LT_SSE2, ALL_SSE2)
+DEFINE_TRIG_KERNELS(avx2, "avx2", 8, __m256, __m256i, _mm256, si256, LT_AVX2, ALL_AVX2)
+DEFINE_TRIG_KERNELS(avx512, "avx512f", 16, __m512, __m512i, _mm512, si512, LT_AVX512, ALL_AVX512)
+
+#endif // TINY3D_X86_SIMD
+
+void trig_sincos_n(const float* x, float* s, float* c, int count, trig_accuracy_t accuracy) {
+    if (count <= 0) return;
+
+    if (accuracy == TRIG_LIBM) {
+        for (int i = 0; i < count; i++) {
+            if (s) s[i] = sinf(x[i]);
+            if (c) c[i] = cosf(x[i]);
+        }
+        return;
+    }
+
+    int fast = accuracy == TRIG_FAST;
+    int done = 0;
+#ifdef TINY3D_X86_SIMD
+    switch (simd_active_isa()) {
+    case TINY3D_ISA_AVX512:
+        done = sincos_avx512(x, s, c, count, fast);
+        break;
+    case TINY3D_ISA_AVX2:
+        done = sincos_avx2(x, s, c, count, fast);
+        break;
+    case TINY3D_ISA_SSE2:
+        done = sincos_sse2(x, s, c, count, fast);
+        break;
+    default:
+        break;
+    }
+#endif
+    sincos_scalar(x, s, c, done, count, fast);
+}
+
+void trig_acos_n(const float* x, float* out, int count, trig_accuracy_t accuracy) {
+    if (count <= 0) return;
+
+    if (accuracy == TRIG_LIBM) {
+        for (int i = 0; i < count; i++) out[i] = acosf(x[i]);
+        return;
+    }
+
+    int fast = accuracy == TRIG_FAST;
+    int done = 0;
+#ifdef TINY3D_X86_SIMD
+    switch (simd_active_isa()) {
+    case TINY3D_ISA_AVX512:
+        done = acos_avx512(x, out, count, fast);
+        break;
+    case TINY3D_ISA_AVX2:
+        done = acos_avx2(x, out, count, fast);
+        break;
+    case TINY3D_ISA_SSE2:
+        done = acos_sse2(x, out, count, fast);
+        break;
+    default:
+        break;
+    }
+#endif
+    acos_scalar(x, out, done, count, fast);
+}
+
+void trig_atan2_n(const float* y, const float* x, float* out, int count, trig_accuracy_t accuracy) {
+    if (count <= 0) return;
+
+    if (accuracy == TRIG_LIBM) {
+        for (int i = 0; i < count; i++) out[i] = atan2f(y[i], x[i]);
+        return;
+    }
+
+    int fast = accuracy == TRIG_FAST;
+    int done = 0;
+#ifdef TINY3D_X86_SIMD
+    switch (simd_active_isa()) {
+    case TINY3D_ISA_AVX512:
+        done = atan2_avx512(y, x, out, count, fast);
+        break;
+    case TINY3D_ISA_AVX2:
+        done = atan2_avx2(y, x, out, count, fast);
+        break;
+    case TINY3D_ISA_SSE2:
+        done = atan2_sse2(y, x, out, count, fast);
+        break;
+    default:
+        break;
+    }
+#endif
+    atan2_scalar(y, x, out, done, count, fast);
+}
+
+/* Single values go straight to the scalar kernels */
+void trig_sincos(float x, float* s, float* c, trig_accuracy_t accuracy) {
+    if (accuracy == TRIG_LIBM) {
+        *s = sinf(x);
+        *c = cosf(x);
+        return;
+    }
+    sincos_scalar(&x, s, c, 0, 1, accuracy == TRIG_FAST);
+}
+
+float trig_acos(float x, trig_accuracy_t accuracy) {
+    if (accuracy == TRIG_LIBM) return acosf(x);
+    float out;
+    acos_scalar(&x, &out, 0, 1, accuracy == TRIG_FAST);
+    return out;
+}
+
+float trig_atan2(float y, float x, trig_accuracy_t accuracy) {
+    if (accuracy == TRIG_LIBM) return atan2f(y, x);
+    float out;
+    atan2_scalar(&y, &x, &out, 0, 1, accuracy == TRIG_FAST);
+    return out;
+}
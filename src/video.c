@@ -0,0 +1,201 @@
+#include "video.h"
+#include "stats.h"
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if !defined(TINY3D_NO_THREADS) && !defined(_WIN32)
+#define TINY3D_PTHREADS 1
+#include <pthread.h>
+#endif
+
+#ifdef _WIN32
+#include <io.h>
+#define write _write
+#else
+#include <unistd.h>
+#endif
+
+struct video_writer {
+    int fd;
+    int width;
+    int height;
+    size_t luma_size;
+    size_t chroma_size;                      // Both chroma planes together
+    uint8_t* frames[VIDEO_FRAME_BUFFERS];    // Luma planes
+    uint8_t* chroma;                         // Neutral gray, shared by every frame
+    int failed;
+#ifdef TINY3D_PTHREADS
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t ready;                    // Signalled when a frame is queued
+    pthread_cond_t drained;                  // Signalled when a buffer is free again
+    int head;                                // Next buffer to fill
+    int tail;                                // Next buffer to write
+    int queued;
+    int shutdown;
+#endif
+};
+
+static int write_all(int fd, const void* data, size_t len) {
+    const unsigned char* p = (const unsigned char*)data;
+    while (len > 0) {
+        long n = (long)write(fd, p, (unsigned)len);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        p += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+static int write_frame(video_writer_t* w, const uint8_t* luma) {
+    static const char marker[] = "FRAME\n";
+    if (write_all(w->fd, marker, sizeof(marker) - 1) != 0) return -1;
+    if (write_all(w->fd, luma, w->luma_size) != 0) return -1;
+    return write_all(w->fd, w->chroma, w->chroma_size);
+}
+
+#ifdef TINY3D_PTHREADS
+
+static void* writer_main(void* arg) {
+    video_writer_t* w = (video_writer_t*)arg;
+    for (;;) {
+        pthread_mutex_lock(&w->lock);
+        while (w->queued == 0 && !w->shutdown) {
+            pthread_cond_wait(&w->ready, &w->lock);
+        }
+        if (w->queued == 0) {
+            pthread_mutex_unlock(&w->lock);
+            return NULL;
+        }
+        int index = w->tail;
+        int failed = w->failed;
+        pthread_mutex_unlock(&w->lock);
+
+        // Frames after a failed write are dropped, not retried
+        int status = failed ? -1 : write_frame(w, w->frames[index]);
+
+        pthread_mutex_lock(&w->lock);
+        if (status != 0) w->failed = 1;
+        w->tail = (w->tail + 1) % VIDEO_FRAME_BUFFERS;
+        w->queued--;
+        pthread_cond_signal(&w->drained);
+        pthread_mutex_unlock(&w->lock);
+    }
+}
+
+#endif // TINY3D_PTHREADS
+
+static void free_writer(video_writer_t* w) {
+    for (int i = 0; i < VIDEO_FRAME_BUFFERS; i++) free(w->frames[i]);
+    free(w->chroma);
+    free(w);
+}
+
+video_writer_t* video_open_y4m(int fd, int width, int height, int fps) {
+    if (fd < 0 || width <= 0 || height <= 0 || fps <= 0) return NULL;
+
+    video_writer_t* w = (video_writer_t*)calloc(1, sizeof(video_writer_t));
+    if (!w) return NULL;
+    w->fd = fd;
+    w->width = width;
+    w->height = height;
+    w->luma_size = (size_t)width * height;
+    w->chroma_size = 2 * (size_t)((width + 1) / 2) * ((height + 1) / 2);
+
+    w->chroma = (uint8_t*)malloc(w->chroma_size);
+    int ok = w->chroma != NULL;
+    for (int i = 0; i < VIDEO_FRAME_BUFFERS; i++) {
+        w->frames[i] = (uint8_t*)malloc(w->luma_size);
+        ok = ok && w->frames[i];
+    }
+    if (!ok) {
+        free_writer(w);
+        return NULL;
+    }
+    memset(w->chroma, 128, w->chroma_size);
+
+    char header[128];
+    int n = snprintf(header, sizeof(header), "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg XCOLORRANGE=FULL\n",
+                     width, height, fps);
+    if (write_all(fd, header, (size_t)n) != 0) {
+        free_writer(w);
+        return NULL;
+    }
+
+#ifdef TINY3D_PTHREADS
+    pthread_mutex_init(&w->lock, NULL);
+    pthread_cond_init(&w->ready, NULL);
+    pthread_cond_init(&w->drained, NULL);
+    if (pthread_create(&w->thread, NULL, writer_main, w) != 0) {
+        pthread_cond_destroy(&w->drained);
+        pthread_cond_destroy(&w->ready);
+        pthread_mutex_destroy(&w->lock);
+        free_writer(w);
+        return NULL;
+    }
+#endif
+    return w;
+}
+
+static int submit_frame(video_writer_t* w, const canvas_t* canvas) {
+    if (!w || !canvas || canvas->width != w->width || canvas->height != w->height) return -1;
+
+#ifdef TINY3D_PTHREADS
+    // Wait for a free buffer; with two, this only blocks when the writer is a full frame behind
+    pthread_mutex_lock(&w->lock);
+    while (w->queued == VIDEO_FRAME_BUFFERS) {
+        pthread_cond_wait(&w->drained, &w->lock);
+    }
+    int index = w->head;
+    int failed = w->failed;
+    pthread_mutex_unlock(&w->lock);
+    if (failed) return -1;
+
+    canvas_to_u8(canvas, w->frames[index], w->width);
+
+    pthread_mutex_lock(&w->lock);
+    w->head = (w->head + 1) % VIDEO_FRAME_BUFFERS;
+    w->queued++;
+    pthread_cond_signal(&w->ready);
+    pthread_mutex_unlock(&w->lock);
+    return 0;
+#else
+    if (w->failed) return -1;
+    canvas_to_u8(canvas, w->frames[0], w->width);
+    if (write_frame(w, w->frames[0]) != 0) w->failed = 1;
+    return w->failed ? -1 : 0;
+#endif
+}
+
+int video_submit_frame(video_writer_t* w, const canvas_t* canvas) {
+    uint64_t start = stats_stage_begin();
+    int result = submit_frame(w, canvas);
+    stats_stage_end(TINY3D_STAGE_PRESENT, start, 0);
+    return result;
+}
+
+int video_close(video_writer_t* w) {
+    if (!w) return -1;
+
+#ifdef TINY3D_PTHREADS
+    // The thread drains the queue before it sees the shutdown flag
+    pthread_mutex_lock(&w->lock);
+    w->shutdown = 1;
+    pthread_cond_signal(&w->ready);
+    pthread_mutex_unlock(&w->lock);
+    pthread_join(w->thread, NULL);
+    pthread_cond_destroy(&w->drained);
+    pthread_cond_destroy(&w->ready);
+    pthread_mutex_destroy(&w->lock);
+#endif
+
+    int status = w->failed ? -1 : 0;
+    free_writer(w);
+    return status;
+}
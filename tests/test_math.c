@@ -10,6 +10,9 @@ void test_vector_operations() {
     // Test spherical to Cartesian conversion
     vec3_t v = vec3_from_spherical(5.0f, PI/4, PI/3);
     printf("Spherical (5,π/4,π/3) -> Cartesian: (%0.2f, %0.2f, %0.2f)\n", v.x, v.y, v.z);
+    spherical_t sp = vec3_to_spherical(v);
+    printf("Cartesian -> Spherical: (%0.2f, %0.4f, %0.4f), vec3_t is %zu bytes\n",
+           sp.r, sp.theta, sp.phi, sizeof(vec3_t));
     
     // Test fast normalization
     vec3_t v1 = {3.0f, 1.0f, 2.0f};
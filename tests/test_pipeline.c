@@ -1,120 +1,315 @@
 #include "tiny3d.h"
-#include "canvas.h"
-#include "math3d.h"
-#include "renderer.h"
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <math.h>
+#include <time.h>
 
-#define PI 3.14159265358979323846f
-#define WIDTH 800
-#define HEIGHT 600
-
-/* Create a cube model */
-void create_cube(vec3_t** vertices, int** edges, int* vertex_count, int* edge_count) {
-    *vertex_count = 8;
-    *edge_count = 12;
-    
-    *vertices = (vec3_t*)malloc(*vertex_count * sizeof(vec3_t));
-    *edges = (int*)malloc(*edge_count * 2 * sizeof(int));
-    
-    // Cube vertices
-    vec3_t cube[] = {
-        {-1,-1,-1}, {1,-1,-1}, {1,1,-1}, {-1,1,-1},  // Back face
-        {-1,-1,1}, {1,-1,1}, {1,1,1}, {-1,1,1}       // Front face
-    };
-    memcpy(*vertices, cube, sizeof(cube));
-    
-    // Cube edges (vertex indices)
-    int cube_edges[] = {
-        0,1, 1,2, 2,3, 3,0,  // Back face
-        4,5, 5,6, 6,7, 7,4,  // Front face
-        0,4, 1,5, 2,6, 3,7   // Connecting edges
-    };
-    memcpy(*edges, cube_edges, sizeof(cube_edges));
+/* Golden-image regression tests
+ * Every scene is rendered into a fresh canvas and compared, quantized to
+ * 8 bits, against tests/golden/<name>.pgm: each pixel may differ by at most
+ * the scene's tolerance. Scenes with a budget are also timed (best of
+ * BUDGET_RUNS) and fail when the render takes longer.
+ *
+ *   build/test_pipeline [--update] [--golden DIR] [--output DIR]
+ *
+ * --update rewrites the golden images from the current renderer, --output
+ * saves every rendered image for inspection (mismatches are always saved
+ * to build/). TINY3D_BUDGET_SCALE multiplies every budget, e.g. for
+ * sanitizer builds; 0 turns budgets off. */
+
+#define BUDGET_RUNS 3
+
+typedef struct {
+    const char* name;
+    int width;
+    int height;
+    canvas_format_t format;
+    int tolerance;      // Largest per-pixel difference allowed, in 8-bit levels
+    double budget_ms;   // Wall-clock budget for one render (0: none)
+    void (*render)(canvas_t* canvas);
+} golden_scene_t;
+
+static vec3_t* cube_verts;
+static int* cube_edges;
+static int cube_vcount, cube_ecount;
+static thread_pool_t* pool;
+
+static mat4_t view_proj(float distance) {
+    return mat4_mul(mat4_translate(0.0f, 0.0f, -distance), mat4_frustum_asymmetric(-1, 1, -1, 1, 1, 100));
 }
 
-/* Create a pyramid model */
-void create_pyramid(vec3_t** vertices, int** edges, int* vertex_count, int* edge_count) {
-    *vertex_count = 5;
-    *edge_count = 8;
-    
-    *vertices = (vec3_t*)malloc(*vertex_count * sizeof(vec3_t));
-    *edges = (int*)malloc(*edge_count * 2 * sizeof(int));
-    
-    // Pyramid vertices
-    vec3_t pyramid[] = {
-        {-1,-1,-1}, {1,-1,-1}, {1,1,-1}, {-1,1,-1},  // Base
-        {0,0,1}                                      // Apex
-    };
-    memcpy(*vertices, pyramid, sizeof(pyramid));
-    
-    // Pyramid edges
-    int pyramid_edges[] = {
-        0,1, 1,2, 2,3, 3,0,  // Base
-        0,4, 1,4, 2,4, 3,4    // Sides
-    };
-    memcpy(*edges, pyramid_edges, sizeof(pyramid_edges));
+/* UV sphere: meridians and parallels, segs around and segs / 2 rings */
+static void make_sphere(mesh_t* s, int segs) {
+    int rings = segs / 2;
+    s->vertex_count = segs * (rings - 1) + 2;
+    s->vertices = (vec3_t*)malloc(sizeof(vec3_t) * (size_t)s->vertex_count);
+    s->edges = (int*)malloc(sizeof(int) * 2 * (size_t)segs * (2 * rings - 1));
+    s->edge_count = 0;
+    s->mapping = NULL;
+
+    int north = s->vertex_count - 2, south = s->vertex_count - 1;
+    s->vertices[north] = (vec3_t){0.0f, 0.0f, 1.0f};
+    s->vertices[south] = (vec3_t){0.0f, 0.0f, -1.0f};
+    for (int r = 1; r < rings; r++) {
+        for (int k = 0; k < segs; k++) {
+            int v = (r - 1) * segs + k;
+            float theta = (float)M_PI * r / rings, phi = 2.0f * (float)M_PI * k / segs;
+            s->vertices[v] = (vec3_t){sinf(theta) * cosf(phi), sinf(theta) * sinf(phi), cosf(theta)};
+            s->edges[2 * s->edge_count] = v;
+            s->edges[2 * s->edge_count++ + 1] = (r - 1) * segs + (k + 1) % segs;
+            s->edges[2 * s->edge_count] = v;
+            s->edges[2 * s->edge_count++ + 1] = r == 1 ? north : v - segs;
+        }
+    }
+    for (int k = 0; k < segs; k++) {
+        s->edges[2 * s->edge_count] = (rings - 2) * segs + k;
+        s->edges[2 * s->edge_count++ + 1] = south;
+    }
 }
 
-void test_wireframe_rendering() {
-    printf("=== Testing 3D Rendering Pipeline ===\n");
-    
-    // Create canvas
-    canvas_t* canvas = create_canvas(WIDTH, HEIGHT);
-    clear_canvas(canvas, 0.0f);
-    
-    // Create models
-    vec3_t *cube_verts, *pyramid_verts;
-    int *cube_edges, *pyramid_edges;
-    int cube_vcount, cube_ecount, pyramid_vcount, pyramid_ecount;
-    
-    create_cube(&cube_verts, &cube_edges, &cube_vcount, &cube_ecount);
-    create_pyramid(&pyramid_verts, &pyramid_edges, &pyramid_vcount, &pyramid_ecount);
-    
-    // Set up transforms
-    mat4_t model = mat4_rotate_xyz(0.5f, 0.8f, 0.3f);
-    mat4_t view = mat4_translate(0.0f, 0.0f, -5.0f);
-    mat4_t proj = mat4_frustum_asymmetric(-1.0f, 1.0f, -1.0f, 1.0f, 1.0f, 100.0f);
-    mat4_t mvp = mat4_mul(mat4_mul(proj, view), model);
-    
-    // Render cube
-    render_wireframe(canvas, mvp, cube_verts, cube_vcount, cube_edges, cube_ecount, 1.5f);
-    
-    // Move pyramid and render
-    mat4_t pyramid_model = mat4_translate(2.0f, 0.0f, 0.0f);
-    mat4_t pyramid_mvp = mat4_mul(mat4_mul(proj, view), pyramid_model);
-    render_wireframe(canvas, pyramid_mvp, pyramid_verts, pyramid_vcount, pyramid_edges, pyramid_ecount, 1.5f);
-    
-    printf("Rendered cube and pyramid to canvas\n");
-    printf("Canvas dimensions: %dx%d\n", canvas->width, canvas->height);
-    
-    // Cleanup
-    free(cube_verts);
-    free(cube_edges);
-    free(pyramid_verts);
-    free(pyramid_edges);
-    free_canvas(canvas);
+/* Cube and pyramid side by side */
+static void scene_cube_pyramid(canvas_t* canvas) {
+    static vec3_t pyramid[] = { {-1,-1,-1}, {1,-1,-1}, {1,1,-1}, {-1,1,-1}, {0,0,1} };
+    static int pyramid_edges[] = { 0,1, 1,2, 2,3, 3,0, 0,4, 1,4, 2,4, 3,4 };
+    mat4_t vp = view_proj(4.0f);
+
+    // mat4_mul(a, b) applies a first: object to world, then world to clip
+    mat4_t cube = mat4_mul(mat4_rotate_xyz(0.5f, 0.8f, 0.3f), mat4_translate(-1.2f, 0.0f, 0.0f));
+    render_wireframe(canvas, mat4_mul(cube, vp), cube_verts, cube_vcount, cube_edges, cube_ecount, 1.5f);
+    mat4_t apex = mat4_mul(mat4_rotate_xyz(-1.2f, 0.3f, 0.0f), mat4_translate(1.4f, 0.0f, 0.0f));
+    render_wireframe(canvas, mat4_mul(apex, vp), pyramid, 5, pyramid_edges, 8, 1.5f);
+}
+
+/* Spokes of every thickness, reaching past the canvas edges */
+static void scene_clockface(canvas_t* canvas) {
+    float cx = canvas->width * 0.5f, cy = canvas->height * 0.5f;
+    unsigned seed = 12345u;
+    for (int i = 0; i < 50; i++) {
+        // Fixed LCG, so the picture is the same on every libc
+        seed = seed * 1103515245u + 12345u;
+        float angle = (float)(seed >> 8) / 16777216.0f * 2.0f * (float)M_PI;
+        seed = seed * 1103515245u + 12345u;
+        float length = 40.0f + (float)(seed >> 8) / 16777216.0f * 100.0f;
+        float thickness = 0.5f + (float)(i % 7) * 0.5f;
+        draw_line_f(canvas, cx, cy, cx + length * cosf(angle), cy + length * sinf(angle), thickness);
+    }
+}
+
+/* Vertex-lit sphere and edge-lit cube */
+static void scene_lighting(canvas_t* canvas) {
+    light_set_t lights;
+    light_set_init(&lights);
+    light_set_add(&lights, (vec3_t){-1, 1, 1}, 0.8f);
+    light_set_add(&lights, (vec3_t){1, -0.5f, 0.5f}, 0.3f);
+    light_set_add(&lights, (vec3_t){0, 0, -1}, 0.15f);
+
+    mesh_t s;
+    make_sphere(&s, 24);
+    mat4_t vp = view_proj(3.5f);
+    mat4_t ball = mat4_mul(mat4_rotate_xyz(1.2f, 0.2f, 0.0f), mat4_translate(-1.1f, 0.0f, 0.0f));
+    mat4_t cube = mat4_mul(mat4_rotate_xyz(0.4f, 0.7f, 0.0f), mat4_translate(1.3f, 0.0f, 0.0f));
+
+    render_options_t options = {0};
+    options.lights = &lights;
+    options.lighting = RENDER_LIGHT_VERTEX;
+    options.model = &ball;
+    render_wireframe_ex(canvas, mat4_mul(ball, vp), s.vertices, s.vertex_count, s.edges, s.edge_count,
+                        1.5f, &options);
+    options.lighting = RENDER_LIGHT_EDGE;
+    options.model = &cube;
+    render_wireframe_ex(canvas, mat4_mul(cube, vp), cube_verts, cube_vcount, cube_edges, cube_ecount,
+                        2.0f, &options);
+    mesh_free(&s);
+}
+
+/* Hidden-line sphere, with edges crossing the near plane */
+static void scene_depth(canvas_t* canvas) {
+    mesh_t s;
+    make_sphere(&s, 32);
+    z_buffer_t zbuf;
+    init_z_buffer(&zbuf, canvas->width, canvas->height);
+    render_options_t options = {0};
+    options.zbuf = &zbuf;
+
+    mat4_t vp = view_proj(3.0f);
+    mat4_t near = mat4_mul(mat4_scale(1.0f, 1.0f, 2.5f), mat4_rotate_xyz(0.3f, 0.9f, 0.0f));
+    render_wireframe_ex(canvas, mat4_mul(near, vp), s.vertices, s.vertex_count, s.edges, s.edge_count,
+                        1.5f, &options);
+    free_z_buffer(&zbuf);
+    mesh_free(&s);
+}
+
+/* Grid of cube instances on a compact canvas with max blending */
+static void scene_instances(canvas_t* canvas) {
+    mat4_t models[25];
+    for (int i = 0; i < 25; i++) {
+        mat4_t spin = mat4_rotate_xyz(0.2f * i, 0.3f * i, 0.0f);
+        mat4_t scale = mat4_scale(0.3f, 0.3f, 0.3f);
+        models[i] = mat4_mul(mat4_mul(scale, spin), mat4_translate((i % 5 - 2) * 0.8f, (i / 5 - 2) * 0.8f, 0.0f));
+    }
+    canvas->blend = CANVAS_BLEND_MAX;
+    render_wireframe_instanced(canvas, view_proj(5.0f), cube_verts, cube_vcount, cube_edges, cube_ecount,
+                               models, 25, 1.0f, NULL);
 }
 
-void test_circular_clipping() {
-    printf("\n=== Testing Circular Viewport Clipping ===\n");
-    
-    canvas_t* canvas = create_canvas(400, 400);
-    clear_canvas(canvas, 0.0f);
-    
-    // Create a test pattern that extends beyond circular viewport
-    for (float angle = 0; angle < 2*PI; angle += PI/12) {
-        float x = 200 + cosf(angle) * 250;
-        float y = 200 + sinf(angle) * 250;
-        draw_line_f(canvas, 200, 200, x, y, 1.0f);
+/* Rolling terrain, n x n vertices on [-1, 1]^2 */
+static void make_terrain(mesh_t* t, int n) {
+    t->vertex_count = n * n;
+    t->vertices = (vec3_t*)malloc(sizeof(vec3_t) * (size_t)t->vertex_count);
+    t->edges = (int*)malloc(sizeof(int) * 4 * (size_t)n * (n - 1));
+    t->edge_count = 0;
+    t->mapping = NULL;
+    for (int y = 0; y < n; y++) {
+        for (int x = 0; x < n; x++) {
+            float u = 2.0f * x / (n - 1) - 1.0f, v = 2.0f * y / (n - 1) - 1.0f;
+            t->vertices[y * n + x] = (vec3_t){u, v, 0.15f * sinf(6.0f * u) * cosf(4.0f * v)};
+            if (x + 1 < n) {
+                t->edges[2 * t->edge_count] = y * n + x;
+                t->edges[2 * t->edge_count++ + 1] = y * n + x + 1;
+            }
+            if (y + 1 < n) {
+                t->edges[2 * t->edge_count] = y * n + x;
+                t->edges[2 * t->edge_count++ + 1] = (y + 1) * n + x;
+            }
+        }
     }
-    
-    printf("Created test pattern with clipping (should see only lines within circle)\n");
-    free_canvas(canvas);
 }
 
-int main() {
-    test_wireframe_rendering();
-    test_circular_clipping();
+/* Dense terrain through the tiled renderer: the rasterizer under load,
+ * sparse in front and packed toward the horizon */
+static mesh_t dense;
+
+static void scene_dense(canvas_t* canvas) {
+    mat4_t model = mat4_mul(mat4_mul(mat4_scale(3.0f, 6.0f, 1.0f), mat4_rotate_xyz(-1.2f, 0.0f, 0.3f)),
+                            mat4_translate(0.0f, -0.6f, 0.0f));
+    render_wireframe_parallel(pool, canvas, mat4_mul(model, view_proj(5.0f)),
+                              dense.vertices, dense.vertex_count, dense.edges, dense.edge_count, 0.75f);
+}
+
+static const golden_scene_t scenes[] = {
+    { "cube_pyramid", 200, 150, CANVAS_F32,     1, 0.0,   scene_cube_pyramid },
+    { "clockface",    200, 200, CANVAS_F32,     1, 0.0,   scene_clockface },
+    { "lighting",     200, 150, CANVAS_F32,     1, 0.0,   scene_lighting },
+    { "depth",        200, 200, CANVAS_F32,     1, 0.0,   scene_depth },
+    { "instances",    200, 200, CANVAS_UNORM8,  1, 0.0,   scene_instances },
+    { "dense",        320, 240, CANVAS_UNORM16, 1, 250.0, scene_dense },
+};
+
+static double now_ms(void) {
+    struct timespec ts;
+#ifdef _WIN32
+    timespec_get(&ts, TIME_UTC);
+#else
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+#endif
+    return (double)ts.tv_sec * 1e3 + (double)ts.tv_nsec * 1e-6;
+}
+
+/* 8-bit binary PGM as canvas_write_pgm writes it; returns the pixels or NULL */
+static uint8_t* load_pgm(const char* path, int width, int height) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return NULL;
+    int w, h, maxval;
+    uint8_t* pixels = NULL;
+    if (fscanf(f, "P5 %d %d %d", &w, &h, &maxval) == 3 && fgetc(f) == '\n' &&
+        w == width && h == height && maxval == 255) {
+        pixels = (uint8_t*)malloc((size_t)w * h);
+        if (pixels && fread(pixels, 1, (size_t)w * h, f) != (size_t)w * h) {
+            free(pixels);
+            pixels = NULL;
+        }
+    }
+    fclose(f);
+    return pixels;
+}
+
+int main(int argc, char** argv) {
+    const char* golden_dir = "tests/golden";
+    const char* output_dir = NULL;
+    int update = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--update") == 0) update = 1;
+        else if (strcmp(argv[i], "--golden") == 0 && i + 1 < argc) golden_dir = argv[++i];
+        else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) output_dir = argv[++i];
+    }
+    const char* scale_env = getenv("TINY3D_BUDGET_SCALE");
+    double budget_scale = scale_env ? atof(scale_env) : 1.0;
+
+    printf("=== Golden-image regression tests ===\n");
+    create_cube(&cube_verts, &cube_edges, &cube_vcount, &cube_ecount);
+    pool = thread_pool_create(0);
+    make_terrain(&dense, 224);  // About 100k edges, built outside the timed render
+
+    int failures = 0;
+    char path[512];
+    for (size_t i = 0; i < sizeof(scenes) / sizeof(scenes[0]); i++) {
+        const golden_scene_t* s = &scenes[i];
+        canvas_t* canvas = create_canvas_format(s->width, s->height, s->format);
+        double best = 0.0;
+        for (int run = 0; run < (s->budget_ms > 0.0 && !update ? BUDGET_RUNS : 1); run++) {
+            clear_canvas(canvas, 0.0f);
+            double start = now_ms();
+            s->render(canvas);
+            double elapsed = now_ms() - start;
+            if (run == 0 || elapsed < best) best = elapsed;
+        }
+        resolve_canvas(canvas, 1.0f);
+
+        snprintf(path, sizeof(path), "%s/%s.pgm", golden_dir, s->name);
+        if (update) {
+            int ok = save_canvas_to_pgm(canvas, path) == 0;
+            printf("%s %s -> %s\n", ok ? "✓" : "✗", s->name, path);
+            failures += !ok;
+            free_canvas(canvas);
+            continue;
+        }
+        if (output_dir) {
+            snprintf(path, sizeof(path), "%s/%s.pgm", output_dir, s->name);
+            save_canvas_to_pgm(canvas, path);
+            snprintf(path, sizeof(path), "%s/%s.pgm", golden_dir, s->name);
+        }
+
+        uint8_t* actual = (uint8_t*)malloc((size_t)s->width * s->height);
+        canvas_to_u8(canvas, actual, s->width);
+        uint8_t* expected = load_pgm(path, s->width, s->height);
+        int worst = 0, differing = 0;
+        for (int p = 0; expected && p < s->width * s->height; p++) {
+            int d = abs(actual[p] - expected[p]);
+            if (d > worst) worst = d;
+            differing += d > 0;
+        }
+
+        double budget = s->budget_ms * budget_scale;
+        if (!expected) {
+            printf("✗ %s: no golden image at %s (run with --update)\n", s->name, path);
+        } else if (worst > s->tolerance) {
+            snprintf(path, sizeof(path), "build/%s.actual.pgm", s->name);
+            save_canvas_to_pgm(canvas, path);
+            printf("✗ %s: %d pixels differ, up to %d levels (tolerance %d); image saved to %s\n",
+                   s->name, differing, worst, s->tolerance, path);
+        } else if (budget > 0.0 && best > budget) {
+            printf("✗ %s: %.2f ms over its %.2f ms budget\n", s->name, best, budget);
+        } else {
+            printf("✓ %s: matches golden (max diff %d)", s->name, worst);
+            if (budget > 0.0) printf(", %.2f of %.2f ms", best, budget);
+            printf("\n");
+        }
+        failures += !expected || worst > s->tolerance || (budget > 0.0 && best > budget);
+
+        free(expected);
+        free(actual);
+        free_canvas(canvas);
+    }
+
+    mesh_free(&dense);
+    thread_pool_destroy(pool);
+    free(cube_verts);
+    free(cube_edges);
+    if (failures) {
+        printf("✗ %d scene(s) failed\n", failures);
+        return 1;
+    }
+    printf("✓ All scenes passed!\n");
     return 0;
-}
\ No newline at end of file
+}